@@ -3,42 +3,200 @@
 #include <type_traits>
 #include <mutex>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
 
+// Context with its own lock, owned by the instance using the context. A thread holding the lock has the context
+// current. Nested locks of the owning thread only check the thread id and count, the mutex is not touched.
+// Locks of different holders nest per thread, unlocking one makes the context current before it again
 template<typename Context>
-class ContextManager
+class ContextHolder
 {
-	static inline std::recursive_mutex rMutex;
-	static inline size_t counter{};
+public:
+	struct Stats
+	{
+		uint64_t acquisitions;
+		uint64_t contendedAcquisitions; // Had to wait for another thread
+		uint64_t reentries;             // Nested locks taken by the fast path
+		double totalWaitMs;
+		double maxWaitMs;
+		double totalHoldMs;
+		double maxHoldMs;
+	};
+
+private:
+	using Clock = std::chrono::steady_clock;
+
 	static inline std::function<void(Context*)> contextSetter;
+	static inline thread_local Context* currentContext = nullptr; // Made current by a holder on this thread
+
+	Context* context = nullptr;
+	Context* previousContext = nullptr; // Owner only
+	std::mutex mux;
+	std::atomic<std::thread::id> ownerThread;
+	size_t depth = 0; // Owner only
+	Clock::time_point holdStart;
+
+	std::atomic<uint64_t> acquisitions = 0;
+	std::atomic<uint64_t> contendedAcquisitions = 0;
+	std::atomic<uint64_t> reentries = 0;
+	std::atomic<uint64_t> totalWaitNs = 0;
+	std::atomic<uint64_t> maxWaitNs = 0;
+	std::atomic<uint64_t> totalHoldNs = 0;
+	std::atomic<uint64_t> maxHoldNs = 0;
+
+	static void UpdateMax(std::atomic<uint64_t>& maxValue, uint64_t value)
+	{
+		uint64_t current = maxValue.load(std::memory_order_relaxed);
+
+		while (current < value && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed));
+	}
+
+	static uint64_t NsSince(Clock::time_point start)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+	}
+
 public:
-	ContextManager(Context* context)
+	ContextHolder(Context* context = nullptr)
+		: context(context)
+	{}
+
+	ContextHolder(const ContextHolder&) = delete;
+	ContextHolder& operator=(const ContextHolder&) = delete;
+
+	// Without a setter contexts are only locked, not made current
+	static void SetContextSetter(std::function<void(Context*)> contextSetter)
 	{
+		ContextHolder<Context>::contextSetter = contextSetter;
+	}
+
+	// Not while another thread holds the lock
+	void SetContext(Context* context)
+	{
+		this->context = context;
+	}
+
+	Context* GetContext()
+	{
+		return context;
+	}
+
+	void Lock()
+	{
+		const std::thread::id thisThread = std::this_thread::get_id();
+
+		// Only this thread could have stored its own id, so a relaxed read is enough
+		if (ownerThread.load(std::memory_order_relaxed) == thisThread)
+		{
+			++depth;
+			++reentries;
+			return;
+		}
+
+		const Clock::time_point waitStart = Clock::now();
+
+		if (!mux.try_lock())
+		{
+			++contendedAcquisitions;
+			mux.lock();
+		}
+
+		const uint64_t waitNs = NsSince(waitStart);
+		totalWaitNs += waitNs;
+		UpdateMax(maxWaitNs, waitNs);
+		++acquisitions;
+
+		ownerThread.store(thisThread, std::memory_order_relaxed);
+		depth = 1;
+		holdStart = Clock::now();
+
+		previousContext = currentContext;
+		currentContext = context;
+
 		if (contextSetter)
 		{
-			rMutex.lock();
-			if (!counter)
-			{
-				contextSetter(context);
-			}
-			++counter;
+			contextSetter(context);
 		}
 	}
 
-	~ContextManager()
+	void Unlock()
 	{
+		if (--depth)
+		{
+			return;
+		}
+
+		currentContext = previousContext;
+		previousContext = nullptr;
+
 		if (contextSetter)
 		{
-			--counter;
-			if (!counter)
-			{
-				contextSetter(nullptr);
-			}
-			rMutex.unlock();
+			contextSetter(currentContext);
 		}
+
+		const uint64_t holdNs = NsSince(holdStart);
+		totalHoldNs += holdNs;
+		UpdateMax(maxHoldNs, holdNs);
+
+		ownerThread.store(std::thread::id(), std::memory_order_relaxed);
+		mux.unlock();
+	}
+
+	bool IsOwnedByThisThread()
+	{
+		return ownerThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+	}
+
+	Stats GetStats()
+	{
+		return {
+			acquisitions,
+			contendedAcquisitions,
+			reentries,
+			totalWaitNs / 1000000.0,
+			maxWaitNs / 1000000.0,
+			totalHoldNs / 1000000.0,
+			maxHoldNs / 1000000.0
+		};
 	}
 
+	void ResetStats()
+	{
+		acquisitions = 0;
+		contendedAcquisitions = 0;
+		reentries = 0;
+		totalWaitNs = 0;
+		maxWaitNs = 0;
+		totalHoldNs = 0;
+		maxHoldNs = 0;
+	}
+};
+
+// Holds the lock of a context for the scope
+template<typename Context>
+class ContextManager
+{
+	ContextHolder<Context>& holder;
+public:
+	ContextManager(ContextHolder<Context>& holder)
+		: holder(holder)
+	{
+		holder.Lock();
+	}
+
+	~ContextManager()
+	{
+		holder.Unlock();
+	}
+
+	ContextManager(const ContextManager&) = delete;
+	ContextManager& operator=(const ContextManager&) = delete;
+
 	static void SetContextSetter(std::function<void(Context*)> contextSetter)
 	{
-		ContextManager<Context>::contextSetter = contextSetter;
+		ContextHolder<Context>::SetContextSetter(contextSetter);
 	}
 };
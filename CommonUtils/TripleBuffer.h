@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands values over from one writer thread to one reader thread without locks.
+// Writer fills its buffer and publishes it, reader always gets the latest published one.
+// Neither waits for the other, buffers not picked up in time are simply overwritten
+template<typename Type>
+class TripleBuffer
+{
+	constexpr static uint8_t indexMask = 0b011;
+	constexpr static uint8_t freshBit  = 0b100;
+
+	std::array<Type, 3> buffers{};
+
+	// Index of the buffer between the threads, with freshBit set if it was not picked up by the reader yet
+	std::atomic<uint8_t> middle = 1;
+	uint8_t writeIndex = 0;
+	uint8_t readIndex = 2;
+
+public:
+	// Writer only. Contents are the ones of a buffer published a few times ago, not cleared
+	Type& GetWriteBuffer() noexcept
+	{
+		return buffers[writeIndex];
+	}
+
+	// Writer only
+	void Publish() noexcept
+	{
+		writeIndex = middle.exchange(writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+	}
+
+	// Any thread
+	bool HasUnconsumed() const noexcept
+	{
+		return middle.load(std::memory_order_acquire) & freshBit;
+	}
+
+	// Reader only. Same buffer as before if nothing was published since, true if a new one was picked up
+	bool Consume() noexcept
+	{
+		if (!HasUnconsumed())
+		{
+			return false;
+		}
+
+		readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+		return true;
+	}
+
+	// Reader only
+	const Type& GetReadBuffer() const noexcept
+	{
+		return buffers[readIndex];
+	}
+};
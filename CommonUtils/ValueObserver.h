@@ -2,10 +2,33 @@
 
 #include <functional>
 
+// Shared by observers of all types, so a change of any observed value can be reacted to in one place
+class ValueObserverNotifier
+{
+	static inline std::function<void()> valueChangeCallback;
+
+public:
+	// Not synchronized, must be set before observed values are changed from other threads
+	static void SetValueChangeCallback(std::function<void()> callback) noexcept
+	{
+		valueChangeCallback = std::move(callback);
+	}
+
+protected:
+	static void NotifyValueChange()
+	{
+		if (valueChangeCallback)
+		{
+			valueChangeCallback();
+		}
+	}
+};
+
 template<typename Type>
-class ValueObserver
+class ValueObserver : private ValueObserverNotifier
 {
 	bool updateRequired{};
+	bool callbackPending{};
 
 	Type lastValue{};
 	Type currentValue{};
@@ -15,6 +38,8 @@ class ValueObserver
 
 	void ExecuteValueUpdateCallback()
 	{
+		NotifyValueChange();
+
 		if (valueUpdateCallback)
 		{
 			valueUpdateCallback();
@@ -69,6 +94,16 @@ public:
 	}
 
 	bool Update()
+	{
+		const bool updated = ApplyUpdate();
+		FlushUpdateCallback();
+
+		return updated;
+	}
+
+	// Applies accumulated change without executing the callback, so observers can be updated from several threads.
+	// Callback is held until FlushUpdateCallback
+	bool ApplyUpdate()
 	{
 		constexpr static Type zeroedOutValue{};
 
@@ -80,7 +115,7 @@ public:
 			currentValue += accumulatedValue;
 			accumulatedValue = zeroedOutValue;
 
-			ExecuteValueUpdateCallback();
+			callbackPending = true;
 
 			return true;
 		}
@@ -88,6 +123,16 @@ public:
 		return false;
 	}
 
+	void FlushUpdateCallback()
+	{
+		if (callbackPending)
+		{
+			callbackPending = false;
+
+			ExecuteValueUpdateCallback();
+		}
+	}
+
 	void SetLastValue()
 	{
 		currentValue = lastValue;
@@ -267,11 +267,13 @@ bool CMainWindow::SetSelectedScriptDLLInfo(std::generator<EverettStructs::BasicF
 void CMainWindow::OnEditAmbientLightButton()
 {
 	MFCUtilities::OpenColorSelection([this]() -> glm::vec3& { return engineP->GetAmbientLightVectorAddr(); });
+	engineP->RequestRedraw();
 }
 
 void CMainWindow::OnEditBackgroundColorButtonClick()
 {
 	MFCUtilities::OpenColorSelection([this]() -> glm::vec3& { return engineP->GetBackgroundColorVectorAddr(); });
+	engineP->RequestRedraw();
 }
 
 void CMainWindow::OnShowGizmoCheckClick()
@@ -348,6 +348,7 @@ void CObjectEditDialog::OnRotEditButtonClick()
 void CObjectEditDialog::OnColorEditButtonClick()
 {
 	MFCUtilities::OpenColorSelection([this]() -> glm::vec3& { return castedLightInterface->GetColorVectorAddr(); });
+	engineRef.RequestRedraw();
 }
 
 void CObjectEditDialog::OnAutoScaleButtonClicked()
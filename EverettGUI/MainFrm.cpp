@@ -71,6 +71,8 @@ CMainFrame::CMainFrame() noexcept
 		GetActiveWindow()->SetIcon(AfxGetApp()->LoadIconW(IDR_MAINFRAME), false);
 		engine.SetDefaultWASDControls();
 		engine.EnableGizmoCreation();
+		// Editor is idle most of the time
+		engine.EnableOnDemandRendering();
 	}
 	catch (const EverettException&)
 	{
@@ -16,6 +16,20 @@ struct Config
 	bool fullscreenForce = false;
 	bool debugText = false;
 	bool defaultWASD = false;
+	bool dynamicResolution = false;
+	float targetFrameTime = 16.6f;
+	int textureBudgetMB = 0; // 0 keeps texture streaming off
+	int headlessFrames = 0; // 0 renders to a visible window
+	float fixedDeltaTime = 0.0f;
+	std::string lastFramePath;
+	int framesInFlight = 0; // 0 keeps the default
+	int jobWorkers = -1; // Negative keeps the default
+	bool simulationThread = false;
+	bool sharedContextUpload = false;
+	float simulationRate = 0.0f; // 0 steps once per frame
+	std::string logFile;
+	int logLevel = -1; // Negative keeps the default
+	bool nullRender = false;
 };
 
 bool ReadConfigFile(Config& config)
@@ -40,6 +54,20 @@ bool ReadConfigFile(Config& config)
 	expectedKeys.emplace("FullscreenForce", indexer++);
 	expectedKeys.emplace("DebugText",       indexer++);
 	expectedKeys.emplace("DefaultWASD",     indexer++);
+	expectedKeys.emplace("DynamicResolution", indexer++);
+	expectedKeys.emplace("TargetFrameTime", indexer++);
+	expectedKeys.emplace("TextureBudgetMB", indexer++);
+	expectedKeys.emplace("HeadlessFrames",  indexer++);
+	expectedKeys.emplace("FixedDeltaTime",  indexer++);
+	expectedKeys.emplace("LastFramePath",   indexer++);
+	expectedKeys.emplace("FramesInFlight",  indexer++);
+	expectedKeys.emplace("JobWorkers",      indexer++);
+	expectedKeys.emplace("SimulationThread", indexer++);
+	expectedKeys.emplace("SharedContextUpload", indexer++);
+	expectedKeys.emplace("SimulationRate",  indexer++);
+	expectedKeys.emplace("LogFile",         indexer++);
+	expectedKeys.emplace("LogLevel",        indexer++);
+	expectedKeys.emplace("NullRender",      indexer++);
 
 	expectedKeys.SetDefaultValue(-1);
 
@@ -75,6 +103,48 @@ bool ReadConfigFile(Config& config)
 			case 6:
 				config.defaultWASD = std::stoi(value);
 				break;
+			case 7:
+				config.dynamicResolution = std::stoi(value);
+				break;
+			case 8:
+				config.targetFrameTime = std::stof(value);
+				break;
+			case 9:
+				config.textureBudgetMB = std::stoi(value);
+				break;
+			case 10:
+				config.headlessFrames = std::stoi(value);
+				break;
+			case 11:
+				config.fixedDeltaTime = std::stof(value);
+				break;
+			case 12:
+				config.lastFramePath = value;
+				break;
+			case 13:
+				config.framesInFlight = std::stoi(value);
+				break;
+			case 14:
+				config.jobWorkers = std::stoi(value);
+				break;
+			case 15:
+				config.simulationThread = std::stoi(value);
+				break;
+			case 16:
+				config.sharedContextUpload = std::stoi(value);
+				break;
+			case 17:
+				config.simulationRate = std::stof(value);
+				break;
+			case 18:
+				config.logFile = value;
+				break;
+			case 19:
+				config.logLevel = std::stoi(value);
+				break;
+			case 20:
+				config.nullRender = std::stoi(value);
+				break;
 			}
 		}
 	}
@@ -90,8 +160,28 @@ int main(int argc, char* argv[])
 	{
 		try
 		{
+			if (config.nullRender)
+			{
+				EverettEngine::EnableNullRenderBackend();
+			}
+
 			EverettEngine engine;
 
+			if (config.logLevel >= 0)
+			{
+				engine.SetLogLevel(config.logLevel);
+			}
+
+			if (!config.logFile.empty())
+			{
+				engine.SetLogFile(config.logFile);
+			}
+
+			if (config.headlessFrames > 0)
+			{
+				engine.EnableHeadlessMode(config.headlessFrames, config.fixedDeltaTime, !config.lastFramePath.empty());
+			}
+
 			engine.CreateAndSetupMainWindow(
 				config.windowWidth,
 				config.windowHeight,
@@ -105,8 +195,48 @@ int main(int argc, char* argv[])
 				engine.SetDefaultWASDControls();
 			}
 
+			if (config.dynamicResolution)
+			{
+				engine.EnableDynamicResolution(true, config.targetFrameTime);
+			}
+
+			if (config.textureBudgetMB > 0)
+			{
+				engine.EnableTextureStreaming(true, config.textureBudgetMB);
+			}
+
+			if (config.framesInFlight > 0)
+			{
+				engine.SetFramesInFlight(config.framesInFlight);
+			}
+
+			if (config.jobWorkers >= 0)
+			{
+				engine.SetJobWorkerAmount(config.jobWorkers);
+			}
+
+			if (config.simulationThread)
+			{
+				engine.EnableSimulationThread();
+			}
+
+			if (config.sharedContextUpload)
+			{
+				engine.EnableSharedContextUpload();
+			}
+
+			if (config.simulationRate > 0.0f)
+			{
+				engine.SetFixedSimulationRate(config.simulationRate);
+			}
+
 			engine.LoadWorldFromFile(config.startSave);
 			engine.RunRenderWindow();
+
+			if (config.headlessFrames > 0 && !config.lastFramePath.empty())
+			{
+				engine.SaveLastFrame(config.lastFramePath);
+			}
 		}
 		catch (const EverettException&)
 		{
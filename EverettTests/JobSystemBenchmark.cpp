@@ -0,0 +1,102 @@
+#include "JobSystem.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+	template<typename Func>
+	double MeasureMs(Func&& func, size_t repeats = 5)
+	{
+		double best = 0.0;
+
+		// Best of the repeats, the first runs also warm up the workers and caches
+		for (size_t i = 0; i < repeats; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			func();
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			best = i ? std::min(best, ms) : ms;
+		}
+
+		return best;
+	}
+
+	// Cost of an item is close to a transform update of a sim
+	void Workload(std::vector<float>& values, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			float value = values[i];
+
+			for (int j = 0; j < 64; ++j)
+			{
+				value = std::sin(value) * 0.5f + std::cos(value) * 0.5f;
+			}
+
+			values[i] = value;
+		}
+	}
+}
+
+// Scheduling overhead per job and ParallelFor scaling over a serial loop, for every worker amount up to the hardware
+void RunJobSystemBenchmark()
+{
+	constexpr size_t emptyJobAmount = 100000;
+	constexpr size_t itemAmount = 1 << 18;
+
+	std::vector<float> values(itemAmount, 1.0f);
+
+	const double serialMs = MeasureMs([&values]() { Workload(values, 0, values.size()); });
+
+	std::cout << "Serial loop of " << itemAmount << " items: " << std::fixed << std::setprecision(3) << serialMs << " ms\n";
+	std::cout << "threads | ns per empty job | ParallelFor ms | speedup\n";
+
+	// No workers, powers of two and the default pool
+	const size_t maxWorkers = std::max<size_t>(JobSystem::GetDefaultWorkerAmount(), 1);
+	std::vector<size_t> workerAmounts = { 0 };
+
+	for (size_t workerAmount = 1; workerAmount < maxWorkers; workerAmount *= 2)
+	{
+		workerAmounts.push_back(workerAmount);
+	}
+
+	workerAmounts.push_back(maxWorkers);
+
+	for (size_t workerAmount : workerAmounts)
+	{
+		JobSystem jobSystem(workerAmount);
+
+		const double scheduleMs = MeasureMs([&jobSystem]()
+		{
+			JobSystem::Counter counter;
+
+			for (size_t i = 0; i < emptyJobAmount; ++i)
+			{
+				jobSystem.Schedule([]() {}, &counter);
+			}
+
+			jobSystem.Wait(counter);
+		});
+
+		const double parallelMs = MeasureMs([&jobSystem, &values]()
+		{
+			jobSystem.ParallelFor(
+				values.size(), 
+				[&values](size_t begin, size_t end) { Workload(values, begin, end); }, 
+				1024
+			);
+		});
+
+		// Calling thread works too
+		std::cout 
+			<< std::setw(7) << workerAmount + 1 << " | " 
+			<< std::setw(16) << scheduleMs * 1000000.0 / emptyJobAmount << " | "
+			<< std::setw(14) << parallelMs << " | " 
+			<< std::setw(7) << serialMs / parallelMs << '\n';
+	}
+}
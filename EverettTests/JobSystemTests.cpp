@@ -0,0 +1,209 @@
+#include "TestUtils.h"
+
+#include "JobSystem.h"
+
+#include <vector>
+#include <mutex>
+#include <numeric>
+
+namespace
+{
+	// No workers (jobs run on scheduling), a single worker (stealing has no one to steal from) and a full pool
+	std::vector<size_t> GetWorkerAmountsToTest()
+	{
+		return { 0, 1, std::max<size_t>(JobSystem::GetDefaultWorkerAmount(), 3) };
+	}
+
+	void TestSchedule(size_t workerAmount)
+	{
+		JobSystem jobSystem(workerAmount);
+		JobSystem::Counter counter;
+		std::atomic<size_t> executed = 0;
+
+		constexpr size_t jobAmount = 10000;
+
+		for (size_t i = 0; i < jobAmount; ++i)
+		{
+			jobSystem.Schedule([&executed]() { ++executed; }, &counter);
+		}
+
+		jobSystem.Wait(counter);
+
+		TestCheck(counter.IsDone());
+		TestCheck(executed == jobAmount);
+
+		// Jobs without a counter are finished by the time the system is destroyed
+		std::atomic<size_t> detachedExecuted = 0;
+
+		{
+			JobSystem detachedSystem(workerAmount);
+
+			for (size_t i = 0; i < 100; ++i)
+			{
+				detachedSystem.Schedule([&detachedExecuted]() { ++detachedExecuted; });
+			}
+		}
+
+		TestCheck(detachedExecuted == 100);
+	}
+
+	void TestDependencyChain(size_t workerAmount)
+	{
+		JobSystem jobSystem(workerAmount);
+
+		constexpr size_t chainLength = 64;
+		std::vector<JobSystem::Counter> counters(chainLength);
+		std::mutex orderMux;
+		std::vector<size_t> order;
+
+		// Job waits for the previous one, unless it is finished already by the time the job is scheduled
+		for (size_t i = 0; i < chainLength; ++i)
+		{
+			jobSystem.Schedule(
+				[&orderMux, &order, i]()
+				{
+					// Gives the next jobs time to be scheduled while this one runs
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+					std::lock_guard<std::mutex> lock(orderMux);
+					order.push_back(i);
+				},
+				&counters[i],
+				i ? &counters[i - 1] : nullptr
+			);
+		}
+
+		jobSystem.Wait(counters.back());
+
+		std::vector<size_t> expectedOrder(chainLength);
+		std::iota(expectedOrder.begin(), expectedOrder.end(), 0);
+
+		TestCheck(order == expectedOrder);
+
+		// Job depending on a counter of many jobs starts after all of them
+		JobSystem::Counter fanInCounter;
+		JobSystem::Counter finalCounter;
+		std::atomic<size_t> finishedBefore = 0;
+		size_t seenByFinal = 0;
+
+		for (size_t i = 0; i < 256; ++i)
+		{
+			jobSystem.Schedule([&finishedBefore]() { ++finishedBefore; }, &fanInCounter);
+		}
+
+		jobSystem.Schedule([&finishedBefore, &seenByFinal]() { seenByFinal = finishedBefore; }, &finalCounter, &fanInCounter);
+		jobSystem.Wait(finalCounter);
+
+		TestCheck(seenByFinal == 256);
+	}
+
+	void TestNestedWait(size_t workerAmount)
+	{
+		JobSystem jobSystem(workerAmount);
+		JobSystem::Counter outerCounter;
+		std::atomic<size_t> innerExecuted = 0;
+
+		constexpr size_t outerAmount = 32;
+		constexpr size_t innerAmount = 32;
+
+		// Every outer job waits for its own inner jobs, which only works if waiting threads run jobs
+		for (size_t i = 0; i < outerAmount; ++i)
+		{
+			jobSystem.Schedule(
+				[&jobSystem, &innerExecuted]()
+				{
+					JobSystem::Counter innerCounter;
+
+					for (size_t j = 0; j < innerAmount; ++j)
+					{
+						jobSystem.Schedule([&innerExecuted]() { ++innerExecuted; }, &innerCounter);
+					}
+
+					jobSystem.Wait(innerCounter);
+				},
+				&outerCounter
+			);
+		}
+
+		jobSystem.Wait(outerCounter);
+
+		TestCheck(innerExecuted == outerAmount * innerAmount);
+	}
+
+	void TestParallelFor(size_t workerAmount)
+	{
+		JobSystem jobSystem(workerAmount);
+
+		for (size_t count : { size_t(0), size_t(1), size_t(63), size_t(64), size_t(1000), size_t(100003) })
+		{
+			std::vector<std::atomic<int>> hits(count);
+			std::atomic<size_t> rangeErrors = 0;
+
+			jobSystem.ParallelFor(
+				count,
+				[&hits, &rangeErrors, count](size_t begin, size_t end)
+				{
+					if (begin >= end || end > count)
+					{
+						++rangeErrors;
+						return;
+					}
+
+					for (size_t i = begin; i < end; ++i)
+					{
+						++hits[i];
+					}
+				},
+				16
+			);
+
+			// Every index is covered by exactly one range
+			TestCheck(rangeErrors == 0);
+			TestCheck(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& hit) { return hit == 1; }));
+		}
+
+		std::vector<int> items(5000, 1);
+
+		jobSystem.ParallelFor(std::span<int>(items), [](int& item) { item *= 2; }, 100);
+
+		TestCheck(std::all_of(items.begin(), items.end(), [](int item) { return item == 2; }));
+	}
+
+	void TestSetWorkerAmount()
+	{
+		JobSystem jobSystem(2);
+		TestCheck(jobSystem.GetWorkerAmount() == 2);
+
+		jobSystem.SetWorkerAmount(0);
+		TestCheck(jobSystem.GetWorkerAmount() == 0);
+
+		std::atomic<size_t> executed = 0;
+		JobSystem::Counter counter;
+
+		jobSystem.SetWorkerAmount(4);
+		TestCheck(jobSystem.GetWorkerAmount() == 4);
+
+		for (size_t i = 0; i < 1000; ++i)
+		{
+			jobSystem.Schedule([&executed]() { ++executed; }, &counter);
+		}
+
+		jobSystem.Wait(counter);
+		TestCheck(executed == 1000);
+	}
+}
+
+void RunJobSystemTests()
+{
+	for (size_t workerAmount : GetWorkerAmountsToTest())
+	{
+		const std::string suffix = " (" + std::to_string(workerAmount) + " workers)";
+
+		TestUtils::RunTest("JobSystem Schedule" + suffix, [workerAmount]() { TestSchedule(workerAmount); });
+		TestUtils::RunTest("JobSystem dependency chain" + suffix, [workerAmount]() { TestDependencyChain(workerAmount); });
+		TestUtils::RunTest("JobSystem nested Wait" + suffix, [workerAmount]() { TestNestedWait(workerAmount); });
+		TestUtils::RunTest("JobSystem ParallelFor" + suffix, [workerAmount]() { TestParallelFor(workerAmount); });
+	}
+
+	TestUtils::RunTest("JobSystem SetWorkerAmount", TestSetWorkerAmount);
+}
@@ -0,0 +1,25 @@
+#include "TestUtils.h"
+
+#include <cstring>
+
+void RunJobSystemTests();
+void RunJobSystemBenchmark();
+
+// Runs all tests, with "benchmark" argument runs the microbenchmarks instead. Exit code is 0 only if all checks passed
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && !std::strcmp(argv[1], "benchmark"))
+	{
+		RunJobSystemBenchmark();
+
+		return EXIT_SUCCESS;
+	}
+
+	RunJobSystemTests();
+
+	const size_t failedChecks = TestUtils::GetFailedCheckAmount();
+
+	std::cout << (failedChecks ? std::to_string(failedChecks) + " checks failed\n" : "All tests passed\n");
+
+	return failedChecks ? EXIT_FAILURE : EXIT_SUCCESS;
+}
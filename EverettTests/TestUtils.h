@@ -0,0 +1,62 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+
+#define TestCheck(condition) TestUtils::Check(condition, #condition, __FILE__, __LINE__)
+
+class TestUtils
+{
+	static inline size_t failedChecks = 0;
+
+public:
+	static bool Check(bool condition, const char* conditionStr, const char* file, int line)
+	{
+		if (!condition)
+		{
+			++failedChecks;
+			std::cerr << file << '(' << line << "): check failed: " << conditionStr << '\n';
+		}
+
+		return condition;
+	}
+
+	static size_t GetFailedCheckAmount()
+	{
+		return failedChecks;
+	}
+
+	// A test which does not finish within 'timeout' is a deadlock, the whole run is stopped as failed
+	static void RunTest(const std::string& name, std::function<void()> test, std::chrono::seconds timeout = std::chrono::seconds(30))
+	{
+		const size_t failedBefore = failedChecks;
+		std::atomic<bool> finished = false;
+
+		std::thread watchdog([&name, &finished, timeout]()
+		{
+			const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+			while (!finished && std::chrono::steady_clock::now() < deadline)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+
+			if (!finished)
+			{
+				std::cerr << name << ": timed out\n";
+				std::_Exit(EXIT_FAILURE);
+			}
+		});
+
+		test();
+		finished = true;
+		watchdog.join();
+
+		std::cout << (failedChecks == failedBefore ? "[ OK ] " : "[FAIL] ") << name << '\n';
+	}
+};
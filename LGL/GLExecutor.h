@@ -8,15 +8,38 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
 
-#define GLSafeExecute(glFunc, ...) GLExecutor::SafeExecute(#glFunc, glFunc, __VA_ARGS__)
-#define GLSafeExecuteRet(glFunc, ...) GLExecutor::SafeExecuteWithReturn(#glFunc, glFunc, __VA_ARGS__)
+#define GLSafeExecute(glFunc, ...) GLExecutor::SafeExecute(#glFunc, GLCallCounter(#glFunc), glFunc, __VA_ARGS__)
+#define GLSafeExecuteRet(glFunc, ...) GLExecutor::SafeExecuteWithReturn(#glFunc, GLCallCounter(#glFunc), glFunc, __VA_ARGS__)
+
+// Counter of the null backend for the GL function, looked up by name once per call site
+#define GLCallCounter(glFuncName) \
+[]() -> size_t& { static size_t& counter = GLExecutor::GetCallCounter(glFuncName); return counter; }
 
 class GLExecutor
 {
 	static std::unordered_map<GLenum, std::string> errorMessages;
 	static bool assertOnFailure;
+	// glGetError after every call serializes the driver, so it is off unless chosen explicitly
+	static bool checkEveryCall;
+	static std::atomic<size_t> errorCount;
+
+	// Null backend: GL functions are not called, only counted. Every function gets a slot once,
+	// call sites keep a reference to it, so counting a call does not hash its name
+	static bool nullBackend;
+	static std::mutex callCounterMux;
+	static std::map<std::string, size_t*> callCounterSlots;
+	static std::deque<size_t> callCounters;
+	static GLuint nextFakeID;
 
 	template<typename FunctionType>
 	struct ReturnTypeGetter;
@@ -27,42 +50,130 @@ class GLExecutor
 		using Type = ReturnType;
 	};
 
-	static bool CheckForGLErrors(const std::string& annotation)
+	static bool CheckForGLErrors(const char* annotation)
+	{
+		if (!checkEveryCall)
+		{
+			return false;
+		}
+
+		return DrainErrors(annotation);
+	}
+
+	// Fills outputs GL would: names of generated objects and integer queries.
+	// Queries report 1, so status checks (compile, link, query availability) pass
+	template<typename... Types>
+	static void FakeOutputs(std::string_view annotation, const Types&... values)
+	{
+		if constexpr (sizeof...(Types) >= 2)
+		{
+			auto outputPtr = std::get<sizeof...(Types) - 1>(std::tie(values...));
+			using OutputPtrType = std::remove_cvref_t<decltype(outputPtr)>;
+
+			if constexpr (std::is_same_v<OutputPtrType, GLuint*>)
+			{
+				if (annotation.starts_with("glGen"))
+				{
+					const auto amount = std::get<0>(std::tie(values...));
+
+					for (decltype(+amount) i = 0; i < amount; ++i)
+					{
+						outputPtr[i] = ++nextFakeID;
+					}
+
+					return;
+				}
+			}
+
+			if constexpr (
+				std::is_pointer_v<OutputPtrType> && 
+				!std::is_const_v<std::remove_pointer_t<OutputPtrType>> && 
+				std::is_arithmetic_v<std::remove_pointer_t<OutputPtrType>>
+			)
+			{
+				if (annotation.starts_with("glGet"))
+				{
+					*outputPtr = 1;
+				}
+			}
+		}
+	}
+
+	template<typename ReturnType>
+	static ReturnType FakeReturn(std::string_view annotation)
+	{
+		if constexpr (std::is_pointer_v<ReturnType>)
+		{
+			return nullptr;
+		}
+		else
+		{
+			if (annotation == "glCheckFramebufferStatus")
+			{
+				return static_cast<ReturnType>(GL_FRAMEBUFFER_COMPLETE);
+			}
+
+			// Object names and uniform locations
+			return static_cast<ReturnType>(++nextFakeID);
+		}
+	}
+
+public:
+	// Reports every error flag set since the last check, returns true if any was set
+	static bool DrainErrors(const std::string& annotation)
 	{
-#ifdef _DEBUG
 		GLenum errorID{};
 		bool error = false;
 
+		if (nullBackend)
+		{
+			return false;
+		}
+
 		while ((errorID = glGetError()) != GL_NO_ERROR)
 		{
 			error = true;
+			CountError();
 			std::cerr <<
 				"OpenGL ERROR:" << errorMessages[errorID] << (annotation.size() ? " comment: " + annotation : "") << '\n';
 			assert(!assertOnFailure && "OpenGL ERROR: check log");
 		}
 
 		return error;
-#else
-		return false;
-#endif
 	}
 
-public:
-	template<typename GLFunc, typename... Types>
-	static bool SafeExecute(const std::string& annotation, GLFunc glFunc, Types&&... values)
+
+	template<typename GLFunc, typename CounterGetter, typename... Types>
+	static bool SafeExecute(const char* annotation, CounterGetter counterGetter, GLFunc glFunc, Types&&... values)
 	{
+		if (nullBackend)
+		{
+			++counterGetter();
+			FakeOutputs(annotation, values...);
+
+			return true;
+		}
+
 		glFunc(std::forward<Types>(values)...);
 
 		return !CheckForGLErrors(annotation);
 	}
 
-	template<typename GLFunc, typename... Types>
+	template<typename GLFunc, typename CounterGetter, typename... Types>
 	static typename ReturnTypeGetter<GLFunc>::Type SafeExecuteWithReturn(
-		const std::string& annotation, 
+		const char* annotation, 
+		CounterGetter counterGetter,
 		GLFunc glFunc, 
 		Types&&... values
 	)
 	{
+		if (nullBackend)
+		{
+			++counterGetter();
+
+			return FakeReturn<typename ReturnTypeGetter<GLFunc>::Type>(annotation);
+		}
+
 		typename ReturnTypeGetter<GLFunc>::Type res = glFunc(std::forward<Types>(values)...);
 
 		CheckForGLErrors(annotation);
@@ -74,6 +185,77 @@ public:
 	{
 		assertOnFailure = value;
 	}
+
+	static bool GetAssertOnFailure()
+	{
+		return assertOnFailure;
+	}
+
+	static void SetCheckEveryCall(bool value)
+	{
+		checkEveryCall = value;
+	}
+
+	static void CountError()
+	{
+		++errorCount;
+	}
+
+	static size_t GetErrorCount()
+	{
+		return errorCount;
+	}
+
+	static void SetNullBackend(bool value)
+	{
+		nullBackend = value;
+	}
+
+	static bool IsNullBackend()
+	{
+		return nullBackend;
+	}
+
+	// Slot of the function, created on the first call
+	static size_t& GetCallCounter(const std::string& glFuncName)
+	{
+		std::lock_guard<std::mutex> lock(callCounterMux);
+
+		size_t*& slot = callCounterSlots[glFuncName];
+
+		if (!slot)
+		{
+			slot = &callCounters.emplace_back(0);
+		}
+
+		return *slot;
+	}
+
+	// Functions called at least once since the last reset
+	static std::map<std::string, size_t> GetCallCounters()
+	{
+		std::lock_guard<std::mutex> lock(callCounterMux);
+
+		std::map<std::string, size_t> res;
+
+		for (auto& [glFuncName, slot] : callCounterSlots)
+		{
+			if (*slot)
+			{
+				res.emplace(glFuncName, *slot);
+			}
+		}
+
+		return res;
+	}
+
+	// Slots stay, call sites keep references to them
+	static void ResetCallCounters()
+	{
+		std::lock_guard<std::mutex> lock(callCounterMux);
+
+		std::fill(callCounters.begin(), callCounters.end(), 0);
+	}
 };
 
 std::unordered_map<GLenum, std::string> GLExecutor::errorMessages
@@ -87,4 +269,11 @@ std::unordered_map<GLenum, std::string> GLExecutor::errorMessages
 
 };
 
-bool GLExecutor::assertOnFailure = false;
\ No newline at end of file
+bool GLExecutor::assertOnFailure = false;
+bool GLExecutor::checkEveryCall = false;
+std::atomic<size_t> GLExecutor::errorCount = 0;
+bool GLExecutor::nullBackend = false;
+std::mutex GLExecutor::callCounterMux;
+std::map<std::string, size_t*> GLExecutor::callCounterSlots;
+std::deque<size_t> GLExecutor::callCounters;
+GLuint GLExecutor::nextFakeID = 0;
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <string_view>
 
 #include "LGLUniformHasher.h"
 
@@ -14,11 +15,23 @@
 #include <GLFW/glfw3.h>
 
 #include "GLExecutor.h"
+#include "LGLDynamicResolution.h"
+#include "LGLTextureImporter.h"
+#include "LGLTextureUploader.h"
+#include "LGLTextureStreamer.h"
+#include "LGLTextureRegistry.h"
+#include "LGLDebugOutput.h"
+#include "LGLOffscreenTarget.h"
+#include "LGLFrameCapture.h"
+#include "LGLFramePacer.h"
+#include "LGLCommandQueue.h"
+#include "LGLUploadContext.h"
+#include "LGLInputState.h"
 
 #include "LGLKeyToStringMap.h"
 
 #include "ContextManager.h"
-#define ContextLock ContextManager<GLFWwindow> mux(window);
+#define ContextLock ContextManager<GLFWwindow> mux(*windowContext);
 #define HandshakeContextLock \
 PauseRenderingInternal(); \
 ContextLock \
@@ -26,7 +39,16 @@ PauseRenderingInternal(false);
 
 using namespace LGLStructs;
 
+struct LGL::PreparedTexture
+{
+	const Texture* texture = nullptr;
+	size_t key = 0; // Registry key
+	bool imported = false;
+	LGLTextureImporter::ImportedTexture importedTexture;
+};
+
 std::map<GLFWwindow*, LGL*> LGL::contextToInstance;
+int LGL::windowVisibleHint = GLFW_TRUE;
 
 std::map<std::string, LGL::ShaderType> LGL::shaderTypeChoice =
 {
@@ -73,13 +95,53 @@ LGL::LGL()
 	windowHeight = -1;
 	currentVAOToRender = {};
 	window = nullptr;
+	windowContext = std::make_unique<ContextHolder<GLFWwindow>>();
 	pauseRendering = false;
 	externalRenderPauseActive = false;
 	stopRendering = false;
+	onDemandRendering = false;
+	redrawRequested = true;
+	onDemandIdleTick = 0.1f;
+	skippedFrameCount = 0;
 	uniformHasher = std::make_unique<LGLUniformHasher>();
+	dynamicResolution = std::make_unique<LGLDynamicResolution>();
+	headless = false;
+	headlessFrameCount = 0;
+	headlessFixedDeltaTime = 0.0f;
+	headlessReadback = false;
+	renderedFrameCount = 0;
+	lastFrameWidth = 0;
+	lastFrameHeight = 0;
+	offscreenTarget = std::make_unique<LGLOffscreenTarget>();
+	frameCapture = std::make_unique<LGLFrameCapture>();
+	framePacer = std::make_unique<LGLFramePacer>();
+	renderCycleRunning = false;
+	renderCommandMsPerFrame = 2.0f;
+	commandQueue = std::make_unique<LGLCommandQueue>();
+	lastBufferGeneration = 0;
+	uploadContext = std::make_unique<LGLUploadContext>();
+	inputState = std::make_unique<LGLInputState>();
+#ifdef _DEBUG
+	errorCheckMode = GLErrorCheckMode::DebugOutput;
+#else
+	errorCheckMode = GLErrorCheckMode::Sampled;
+#endif
+	errorCheckInterval = 60;
+	framesSinceErrorCheck = 0;
+	debugOutput = std::make_unique<LGLDebugOutput>();
 	batchUniformVals = true;
 	hashUniformVals = true;
 	useVSync = true;
+	textureCompressionSupported = false;
+	asyncTextureUpload = false;
+	textureUploadBytesPerFrame = 4 * 1024 * 1024;
+	textureUploadMsPerFrame = 2.0f;
+	placeholderTexture = 0;
+	textureUploader = std::make_unique<LGLTextureUploader>();
+	textureUploader->SetReadyCallback([this]() { RequestRedraw(); });
+	textureRegistry = std::make_unique<LGLTextureRegistry>();
+	textureStreaming = false;
+	textureStreamer = std::make_unique<LGLTextureStreamer>();
 	renderDeltaTime = 1.0f;
 	renderTextVOCreated = false;
 
@@ -93,9 +155,20 @@ LGL::~LGL()
 		StopRenderingCycle();
 	}
 
+	if (uploadContext->IsRunning())
+	{
+		ContextLock
+
+		uploadContext->Stop();
+	}
+
 	contextToInstance.erase(window);
-	glfwDestroyWindow(window);
+	if (!GLExecutor::IsNullBackend())
+	{
+		glfwDestroyWindow(window);
+	}
 	window = nullptr;
+	windowContext->SetContext(nullptr);
 
 	std::cout << "LambdaGL instance destroyed\n";
 }
@@ -116,12 +189,18 @@ void LGL::DeleteGLObjects()
 		{
 			GLSafeExecute(glDeleteVertexArrays, 1, &VAO.vboId);
 		}
-		for (auto& texture : modelIter.second.textureIDs)
-		{
-			GLSafeExecute(glDeleteTextures, 1, &texture.second);
-		}
+		ReleaseModelTextures(modelIter.second);
 	}
 	internalModelMap.clear();
+
+	textureRegistry->Clear();
+	textureStreamer->Clear();
+	textureUploader->Release();
+	if (placeholderTexture)
+	{
+		GLSafeExecute(glDeleteTextures, 1, &placeholderTexture);
+		placeholderTexture = 0;
+	}
 	internalTextMap.clear();
 
 	for (auto& [_, atlasInfo] : fontnameToAltasInfo)
@@ -164,6 +243,11 @@ void LGL::DeleteGLObjects()
 		uniformHasher->ResetHasher();
 	}
 	lastProgram.clear();
+
+	dynamicResolution->Release();
+	offscreenTarget->Release();
+	frameCapture->Release();
+	framePacer->Release();
 }
 
 bool LGL::CreateWindow(const int width, const int height, const std::string& title, bool fullscreen)
@@ -174,6 +258,32 @@ bool LGL::CreateWindow(const int width, const int height, const std::string& tit
 		return false;
 	}
 
+	if (GLExecutor::IsNullBackend())
+	{
+		// Any unique address does as a handle, it is never passed to GLFW
+		window = reinterpret_cast<GLFWwindow*>(this);
+		windowContext->SetContext(window);
+		windowWidth = width;
+		windowHeight = height;
+
+		std::cout << "Created a null window by address " << window << '\n';
+
+		contextToInstance[window] = this;
+
+		InitGLAD();
+
+		return true;
+	}
+
+	if (headless)
+	{
+		fullscreen = false;
+	}
+
+	// Hints persist until reset, so the visibility is set explicitly for every window
+	windowVisibleHint = headless ? GLFW_FALSE : GLFW_TRUE;
+	glfwWindowHint(GLFW_VISIBLE, windowVisibleHint);
+
 	window = glfwCreateWindow(width, height, title.c_str(), fullscreen ? glfwGetPrimaryMonitor() : nullptr, nullptr);
 
 	windowWidth = width;
@@ -193,6 +303,8 @@ bool LGL::CreateWindow(const int width, const int height, const std::string& tit
 		return false;
 	}
 
+	windowContext->SetContext(window);
+
 	std::cout << "Created a GLFW window by address " << window << '\n';
 
 	contextToInstance[window] = this;
@@ -219,24 +331,103 @@ void LGL::InitOpenGL(int major, int minor)
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef _DEBUG
+	// Drivers are only required to report through debug output in debug contexts
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
 
 	ContextManager<GLFWwindow>::SetContextSetter([](GLFWwindow* context){ glfwMakeContextCurrent(context); });
 
 	std::cout << "OpenGL initialized\n";
 }
 
+void LGL::InitNullBackend()
+{
+	GLExecutor::SetNullBackend(true);
+
+	// Locking is kept, so the measured CPU work includes it
+	ContextManager<GLFWwindow>::SetContextSetter([](GLFWwindow*){});
+
+	std::cout << "Null rendering backend initialized\n";
+}
+
+bool LGL::IsNullBackend()
+{
+	return GLExecutor::IsNullBackend();
+}
+
+LGL::NullBackendStats LGL::GetNullBackendStats()
+{
+	ContextLock
+
+	NullBackendStats stats{};
+
+	for (auto& [glFuncName, callAmount] : GLExecutor::GetCallCounters())
+	{
+		std::string_view name = glFuncName;
+
+		if (name.starts_with("glDraw"))
+		{
+			stats.drawCalls += callAmount;
+		}
+		else if (name.starts_with("glUniform"))
+		{
+			stats.uniformUploads += callAmount;
+		}
+		else if (name.starts_with("glBind") || name == "glActiveTexture" || name == "glUseProgram")
+		{
+			stats.binds += callAmount;
+		}
+
+		stats.totalCalls += callAmount;
+	}
+
+	return stats;
+}
+
+std::map<std::string, size_t> LGL::GetNullBackendCallCounters()
+{
+	ContextLock
+
+	return GLExecutor::GetCallCounters();
+}
+
+void LGL::ResetNullBackendStats()
+{
+	ContextLock
+
+	GLExecutor::ResetCallCounters();
+}
+
 bool LGL::InitGLAD()
 {
 	ContextLock
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (!GLExecutor::IsNullBackend() && !gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
 	{
 		std::cout << "Failed to init GLAD\n";
 		return false;
 	}
 
+	SetGLErrorCheckMode(errorCheckMode, errorCheckInterval);
 	SetDepthTest(DepthTestMode::Less);
 
+	int extensionAmount = 0;
+	GLSafeExecute(glGetIntegerv, GL_NUM_EXTENSIONS, &extensionAmount);
+
+	for (int i = 0; i < extensionAmount; ++i)
+	{
+		const char* extension = reinterpret_cast<const char*>(GLSafeExecuteRet(glGetStringi, GL_EXTENSIONS, i));
+
+		if (extension && std::string_view(extension) == "GL_EXT_texture_compression_s3tc")
+		{
+			textureCompressionSupported = true;
+			break;
+		}
+	}
+
+	std::cout << "S3TC texture compression " << (textureCompressionSupported ? "supported" : "unsupported") << '\n';
+
 	GLSafeExecute(glEnable, GL_BLEND);
 	GLSafeExecute(glBlendFunc, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
@@ -252,12 +443,21 @@ void LGL::InitCallbacks()
 	glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
 	glfwSetErrorCallback(GLFWErrorCallback);
 
+	// Input is always tracked, interactables are dispatched from its state
+	glfwSetKeyCallback(window, KeyPressCallback);
+	glfwSetMouseButtonCallback(window, MouseButtonCallback);
+	glfwSetCursorPosCallback(window, CursorPositionCallback);
+	glfwSetScrollCallback(window, ScrollCallback);
+
 	glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, true);
 }
 
 void LGL::TerminateOpenGL()
 {
-	glfwTerminate();
+	if (!GLExecutor::IsNullBackend())
+	{
+		glfwTerminate();
+	}
 
 	std::cout << "Terminate OpenGL\n";
 }
@@ -281,6 +481,11 @@ void LGL::CaptureMouse(bool value)
 {
 	HandshakeContextLock
 
+	if (GLExecutor::IsNullBackend())
+	{
+		return;
+	}
+
 	glfwSetInputMode(window, GLFW_CURSOR, value ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
 
 	std::cout << "Mouse has been captured\n";
@@ -295,7 +500,6 @@ void LGL::SetFramebufferSizeCallback(std::function<void(int, int)> callbackFunc)
 
 void LGL::SetCursorPositionCallback(std::function<void(double, double)> callbackFunc)
 {
-	glfwSetCursorPosCallback(window, callbackFunc ? CursorPositionCallback : nullptr);
 	cursorPositionFunc = std::move(callbackFunc);
 
 	std::cout << "Cursor callback set\n";
@@ -303,7 +507,6 @@ void LGL::SetCursorPositionCallback(std::function<void(double, double)> callback
 
 void LGL::SetScrollCallback(std::function<void(double, double)> callbackFunc)
 {
-	glfwSetScrollCallback(window, callbackFunc ? ScrollCallback : nullptr);
 	scrollCallbackFunc = std::move(callbackFunc);
 
 	std::cout << "Scroll callback set\n";
@@ -311,7 +514,6 @@ void LGL::SetScrollCallback(std::function<void(double, double)> callbackFunc)
 
 void LGL::SetKeyPressCallback(std::function<void(int, int, int, int)> callbackFunc)
 {
-	glfwSetKeyCallback(window, callbackFunc ? KeyPressCallback : nullptr);
 	keyPressCallbackFunc = std::move(callbackFunc);
 
 	std::cout << "Key press callback set\n";
@@ -338,29 +540,77 @@ int LGL::GetMaxAmountOfVertexAttr()
 
 void LGL::ProcessInput()
 {
-	for (auto& interact : interactCollection)
+	// Only interactables held down or changed since the last frame are visited, not every bound key.
+	// Ones replaced by SetInteractable while held are not pressed anymore and dropped
+	std::erase_if(heldInteractables, [this](size_t key)
+	{
+		auto interactIter = interactCollection.find(key);
+
+		return interactIter == interactCollection.end() || !interactIter->second.pressed;
+	});
+
+	for (size_t key : heldInteractables)
+	{
+		InteractableInfo& interact = interactCollection[key];
+
+		if (interact.holdable && interact.pressedFunc)
+		{
+			interact.pressedFunc();
+		}
+	}
+
+	for (const LGLInputState::KeyEvent& keyEvent : inputState->GetKeyEvents())
 	{
-		int retCode = glfwGetKey(window, static_cast<int>(interact.first));
+		auto interactIter = interactCollection.find(static_cast<size_t>(keyEvent.key));
+
+		if (interactIter == interactCollection.end())
+		{
+			continue;
+		}
+
+		InteractableInfo& interact = interactIter->second;
 
-		if (retCode == GLFW_PRESS)
+		if (keyEvent.pressed && !interact.pressed)
 		{
-			if (interact.second.pressedFunc && (interact.second.holdable || !interact.second.pressed))
+			interact.pressed = true;
+			heldInteractables.push_back(interactIter->first);
+
+			if (interact.pressedFunc)
 			{
-				interact.second.pressedFunc();
+				interact.pressedFunc();
 			}
-
-			interact.second.pressed = true;
 		}
-		else if (retCode == GLFW_RELEASE && interact.second.pressed)
+		else if (!keyEvent.pressed && interact.pressed)
 		{
-			interact.second.pressed = false;
+			interact.pressed = false;
+			heldInteractables.erase(std::find(heldInteractables.begin(), heldInteractables.end(), interactIter->first));
 
-			if (interact.second.releasedFunc)
+			if (interact.releasedFunc)
 			{
-				interact.second.releasedFunc();
+				interact.releasedFunc();
 			}
 		}
 	}
+
+	inputState->ClearKeyEvents();
+
+	// Held keys keep the frames coming in on demand mode
+	if (!heldInteractables.empty())
+	{
+		redrawRequested = true;
+	}
+
+	double xpos, ypos;
+
+	if (inputState->TakeCursorPosition(xpos, ypos) && cursorPositionFunc)
+	{
+		cursorPositionFunc(xpos, ypos);
+	}
+
+	if (inputState->TakeScroll(xpos, ypos) && scrollCallbackFunc)
+	{
+		scrollCallbackFunc(xpos, ypos);
+	}
 }
 
 void LGL::FramebufferSizeCallback(GLFWwindow* window, int width, int height)
@@ -375,6 +625,7 @@ void LGL::FramebufferSizeCallback(GLFWwindow* window, int width, int height)
 		}
 
 		instance->UpdateWindowSize(width, height);
+		instance->redrawRequested = true;
 	}
 }
 
@@ -383,6 +634,149 @@ void LGL::EnableVSync(bool value)
 	useVSync = value;
 }
 
+void LGL::SetFramesInFlight(size_t amount)
+{
+	framePacer->SetFramesInFlight(amount);
+
+	std::cout << "Frames in flight have been set to " << framePacer->GetFramesInFlight() << '\n';
+}
+
+size_t LGL::GetFrameSlot()
+{
+	return framePacer->GetFrameSlot();
+}
+
+float LGL::GetLastFenceWaitTime()
+{
+	return framePacer->GetLastWaitTime();
+}
+
+float LGL::GetAverageFenceWaitTime()
+{
+	return framePacer->GetAverageWaitTime();
+}
+
+void LGL::EnableDynamicResolution(bool value, float targetFrameTimeMs, float minScale, float maxScale)
+{
+	dynamicResolution->Enable(value, targetFrameTimeMs, minScale, maxScale);
+
+	std::cout << "Dynamic resolution has been set to " << value << '\n';
+}
+
+float LGL::GetDynamicResolutionScale()
+{
+	return dynamicResolution->GetCurrentScale();
+}
+
+void LGL::EnableHeadlessMode(bool value, size_t frameCount, float fixedDeltaTime, bool readbackLastFrame)
+{
+	if (window)
+	{
+		std::cout << "Headless mode must be set before the window is created\n";
+		return;
+	}
+
+	headless = value;
+	headlessFrameCount = frameCount;
+	headlessFixedDeltaTime = std::max(fixedDeltaTime, 0.0f);
+	headlessReadback = readbackLastFrame;
+
+	std::cout << "Headless mode has been set to " << value << '\n';
+}
+
+bool LGL::IsHeadless()
+{
+	return headless;
+}
+
+size_t LGL::GetRenderedFrameCount()
+{
+	return renderedFrameCount;
+}
+
+bool LGL::GetLastFrame(std::vector<unsigned char>& pixels, int& width, int& height)
+{
+	if (lastFramePixels.empty())
+	{
+		return false;
+	}
+
+	pixels = lastFramePixels;
+	width = lastFrameWidth;
+	height = lastFrameHeight;
+
+	return true;
+}
+
+bool LGL::SaveLastFrame(const std::string& path)
+{
+	if (lastFramePixels.empty())
+	{
+		std::cout << "No frame has been read back\n";
+		return false;
+	}
+
+	std::fstream file(path, std::ios::out | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		std::cout << "Failed to open " << path << '\n';
+		return false;
+	}
+
+	file << "P6\n" << lastFrameWidth << ' ' << lastFrameHeight << "\n255\n";
+
+	// PPM rows go from the top, alpha is dropped
+	std::vector<char> row(static_cast<size_t>(lastFrameWidth) * 3);
+
+	for (int y = lastFrameHeight - 1; y >= 0; --y)
+	{
+		const unsigned char* src = &lastFramePixels[static_cast<size_t>(y) * lastFrameWidth * 4];
+
+		for (int x = 0; x < lastFrameWidth; ++x)
+		{
+			row[x * 3]     = static_cast<char>(src[x * 4]);
+			row[x * 3 + 1] = static_cast<char>(src[x * 4 + 1]);
+			row[x * 3 + 2] = static_cast<char>(src[x * 4 + 2]);
+		}
+
+		file.write(row.data(), row.size());
+	}
+
+	std::cout << "Last frame saved to " << path << '\n';
+
+	return true;
+}
+
+void LGL::StartFrameCapture(const std::string& path, CaptureFormat format, size_t frameAmount)
+{
+	frameCapture->Start(path, static_cast<LGLFrameCapture::Format>(format), frameAmount);
+
+	std::cout << "Frame capture to " << path << " started\n";
+}
+
+void LGL::StopFrameCapture()
+{
+	frameCapture->Stop();
+
+	std::cout << "Frame capture stopped\n";
+}
+
+bool LGL::IsCapturingFrames()
+{
+	return frameCapture->IsActive();
+}
+
+size_t LGL::GetCapturedFrameCount()
+{
+	return frameCapture->GetWrittenFrames();
+}
+
+size_t LGL::GetDroppedCaptureFrameCount()
+{
+	return frameCapture->GetDroppedFrames();
+}
+
 void LGL::RenderText()
 {
 	ContextLock
@@ -411,7 +805,22 @@ void LGL::RenderText()
 
 		for (auto c : text.second->text)
 		{
-			const LGLStructs::GlyphTexture& glyph = currentGlyphInfo.glyphs.at(c);
+			if (c == '\n')
+			{
+				pos.x = text.second->position.x;
+				pos.y -= text.second->lineHeight * pos.z;
+				continue;
+			}
+
+			auto glyphIter = currentGlyphInfo.glyphs.find(c);
+
+			// Characters out of the atlas are skipped, text passed from logs is not checked beforehand
+			if (glyphIter == currentGlyphInfo.glyphs.end())
+			{
+				continue;
+			}
+
+			const LGLStructs::GlyphTexture& glyph = glyphIter->second;
 
 			float xpos = pos.x + glyph.bitmap_left * pos.z;
 			float ypos = pos.y - (glyph.height - glyph.bitmap_top) * pos.z;
@@ -475,7 +884,14 @@ void LGL::RunRenderingCycle(std::function<void()> additionalSteps)
 	std::array<int, Texture::GetTextureTypeAmount()> textureTypesToUnbind;
 	std::fill(textureTypesToUnbind.begin(), textureTypesToUnbind.end(), false);
 
-	while (!(stopRendering || glfwWindowShouldClose(window)))
+	const bool nullBackend = GLExecutor::IsNullBackend();
+
+	renderedFrameCount = 0;
+	float totalFrameTime = 0.0f;
+	renderThreadID = std::this_thread::get_id();
+	renderCycleRunning = true;
+
+	while (!(stopRendering || (!nullBackend && glfwWindowShouldClose(window))))
 	{
 		if (pauseRendering)
 		{
@@ -483,27 +899,87 @@ void LGL::RunRenderingCycle(std::function<void()> additionalSteps)
 			pauser.wait(pauseLock, [this]() { return !pauseRendering; });
 		}
 
+		if (onDemandRendering && !redrawRequested)
+		{
+			WaitForRedraw();
+		}
+
 		ContextLock
 
-		std::chrono::system_clock::time_point renderStartTime = std::chrono::system_clock::now();
-		glfwSwapInterval(useVSync);
+		std::chrono::steady_clock::time_point renderStartTime = std::chrono::steady_clock::now();
+
+		if (!nullBackend)
+		{
+			// Headless runs are benchmarks, never capped
+			glfwSwapInterval(headless ? 0 : useVSync);
 
-		ProcessInput();
-		glfwPollEvents();
+			// Events of this frame are dispatched within it, not a frame later
+			glfwPollEvents();
+			ProcessInput();
+		}
 
-		GLSafeExecute(glClearColor, background.r, background.g, background.b, 1.0f);
-		GLSafeExecute(glClear, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// Textures of restored models go through the uploader even without async upload
+		if (asyncTextureUpload || textureUploader->GetReadyJob())
+		{
+			ProcessTextureUploads();
+		}
+
+		if (uploadContext->IsRunning())
+		{
+			uploadContext->ProcessFinished();
+		}
+
+		if (commandQueue->GetPendingAmount())
+		{
+			commandQueue->Execute(renderCommandMsPerFrame);
+
+			// Commands left for the next frames keep the cycle going in on demand mode
+			if (commandQueue->GetPendingAmount())
+			{
+				redrawRequested = true;
+			}
+		}
 
+		// Ran before the pass, so the steps can request a redraw of this frame in on demand mode
 		if (additionalSteps)
 		{
 			additionalSteps();
 		}
 
+		if (onDemandRendering && !redrawRequested.exchange(false))
+		{
+			++skippedFrameCount;
+			continue;
+		}
+
+		// Only frames actually rendered are paced, paired with EndFrame. Buffers of a frame in flight are not 
+		// rewritten until the GPU is done with it: text and texture upload buffers are orphaned every frame, 
+		// others can be indexed by GetFrameSlot from here on
+		framePacer->BeginFrame();
+
+		const bool offscreenBound = headless && offscreenTarget->Bind(windowWidth, windowHeight);
+
+		dynamicResolution->BeginFrame(windowWidth, windowHeight);
+
+		GLSafeExecute(glClearColor, background.r, background.g, background.b, 1.0f);
+		GLSafeExecute(glClear, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
 		for (auto& currentModelToProcess : internalModelMap)
 		{
 			auto currentModel = currentModelToProcess.second.GetModelPtr();
 
-			if (!currentModel->render) continue;
+			if (!currentModel || !currentModel->render) continue;
+
+			// Skipped until its resources are back, the frame does not wait for them
+			if (!currentModelToProcess.second.resident)
+			{
+				if (!currentModelToProcess.second.restorePending)
+				{
+					RestoreModel(currentModelToProcess.first, currentModelToProcess.second);
+				}
+
+				continue;
+			}
 
 			SetCurrentShaderProg(currentModel->shaderProgram);
 
@@ -541,6 +1017,11 @@ void LGL::RunRenderingCycle(std::function<void()> additionalSteps)
 							GLSafeExecute(glActiveTexture, GL_TEXTURE0 + convertedTextureType);
 							GLSafeExecute(glBindTexture, GL_TEXTURE_2D, textureID);
 
+							if (textureStreaming)
+							{
+								textureStreamer->MarkSampled(textureID);
+							}
+
 							textureTypesToUnbind[convertedTextureType] = true;
 						}
 					}
@@ -574,24 +1055,213 @@ void LGL::RunRenderingCycle(std::function<void()> additionalSteps)
 			GLSafeExecute(glPolygonMode, GL_FRONT_AND_BACK, GL_FILL);
 		}
 
+		dynamicResolution->EndFrame(windowWidth, windowHeight, offscreenBound ? offscreenTarget->GetFBO() : 0);
+
 		RenderText();
 
-		glfwSwapBuffers(window);
+		// Also collects reads of previous frames after the capture is stopped
+		frameCapture->Process(windowWidth, windowHeight, offscreenBound ? offscreenTarget->GetFBO() : 0);
+
+		if (errorCheckMode == GLErrorCheckMode::Sampled && ++framesSinceErrorCheck >= errorCheckInterval)
+		{
+			framesSinceErrorCheck = 0;
+			GLExecutor::DrainErrors("sampled");
+		}
+
+		if (!nullBackend)
+		{
+			glfwSwapBuffers(window);
+		}
+
+		framePacer->EndFrame();
+
+		renderDeltaTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - renderStartTime).count();
+		totalFrameTime += renderDeltaTime;
+		++renderedFrameCount;
+
+		if (headless && headlessFixedDeltaTime > 0.0f)
+		{
+			renderDeltaTime = headlessFixedDeltaTime;
+		}
 
-		renderDeltaTime = std::chrono::duration<float>(std::chrono::system_clock::now() - renderStartTime).count();
 		if (renderTimeCallbackFunc)
 		{
 			renderTimeCallbackFunc(renderDeltaTime);
 		}
+
+		if (headless && headlessFrameCount && renderedFrameCount >= headlessFrameCount)
+		{
+			stopRendering = true;
+		}
 	}
 
-	stopRendering = true;
-	DeleteGLObjects();
-}
+	if (headless)
+	{
+		ContextLock
+
+		if (headlessReadback && offscreenTarget->ReadPixels(lastFramePixels, lastFrameWidth, lastFrameHeight))
+		{
+			std::cout << "Last frame has been read back\n";
+		}
+
+		std::cout << "Headless run finished: " << renderedFrameCount << " frames, " 
+			<< (renderedFrameCount ? totalFrameTime * 1000.0f / renderedFrameCount : 0.0f) << " ms per frame on average\n";
+	}
+
+	stopRendering = true;
+	renderCycleRunning = false;
+
+	{
+		ContextLock
+
+		// Commands queued while the cycle was stopping are not left without a result
+		commandQueue->Execute();
+
+		// Loader context can only be destroyed by the thread which created the window, which is this one
+		uploadContext->Stop();
+	}
+
+	DeleteGLObjects();
+}
 
 void LGL::StopRenderingCycle()
 {
 	stopRendering = true;
+	RequestRedraw();
+}
+
+void LGL::EnableOnDemandRendering(bool value, float idleTickSeconds)
+{
+	onDemandIdleTick = std::max(idleTickSeconds, 0.001f);
+	onDemandRendering = value;
+	RequestRedraw();
+
+	std::cout << "On demand rendering has been set to " << value << '\n';
+}
+
+void LGL::RequestRedraw()
+{
+	redrawRequested = true;
+
+	// Requests of the render thread itself are picked up by the current iteration, no wake up needed
+	if (onDemandRendering && std::this_thread::get_id() != renderThreadID)
+	{
+		{
+			std::lock_guard<std::mutex> lock(redrawMux);
+		}
+		redrawCondVar.notify_one();
+
+		if (window && !GLExecutor::IsNullBackend())
+		{
+			glfwPostEmptyEvent();
+		}
+	}
+}
+
+size_t LGL::GetSkippedFrameCount()
+{
+	return skippedFrameCount;
+}
+
+// Queue has a single consumer at a time, which is guaranteed by executing commands only with the context lock held
+std::future<void> LGL::ExecuteOnRenderThread(std::function<void()> command)
+{
+	std::future<void> result = commandQueue->Push(std::move(command));
+
+	// Checked after the push, so a cycle stopping meanwhile still executes the command on its way out
+	if (!renderCycleRunning || std::this_thread::get_id() == renderThreadID)
+	{
+		ContextLock
+
+		commandQueue->Execute();
+	}
+	else
+	{
+		RequestRedraw();
+	}
+
+	return result;
+}
+
+void LGL::SetRenderCommandBudget(float msPerFrame)
+{
+	renderCommandMsPerFrame = std::max(msPerFrame, 0.0f);
+
+	std::cout << "Render command budget has been set to " << renderCommandMsPerFrame << " ms\n";
+}
+
+size_t LGL::GetPendingRenderCommandAmount()
+{
+	return commandQueue->GetPendingAmount();
+}
+
+bool LGL::EnableSharedContextUpload(bool value)
+{
+	if (GLExecutor::IsNullBackend() || !window)
+	{
+		std::cout << "Shared context upload needs a window with a real context\n";
+		return false;
+	}
+
+	ContextLock
+
+	if (value)
+	{
+		if (!uploadContext->Start(window, windowVisibleHint, [this]() { RequestRedraw(); }))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		uploadContext->Stop();
+	}
+
+	std::cout << "Shared context upload has been set to " << value << '\n';
+
+	return true;
+}
+
+size_t LGL::GetPendingUploadAmount()
+{
+	return uploadContext->GetPendingAmount();
+}
+
+LGL::ContextLockStats LGL::GetContextLockStats()
+{
+	auto stats = windowContext->GetStats();
+
+	return {
+		stats.acquisitions,
+		stats.contendedAcquisitions,
+		stats.reentries,
+		stats.totalWaitMs,
+		stats.maxWaitMs,
+		stats.totalHoldMs,
+		stats.maxHoldMs
+	};
+}
+
+void LGL::ResetContextLockStats()
+{
+	windowContext->ResetStats();
+}
+
+void LGL::WaitForRedraw()
+{
+	const auto timeout = std::chrono::duration<float>(onDemandIdleTick);
+
+	if (GLExecutor::IsNullBackend() || headless)
+	{
+		std::unique_lock<std::mutex> lock(redrawMux);
+		redrawCondVar.wait_for(lock, timeout, [this]() { return redrawRequested || stopRendering; });
+	}
+	else
+	{
+		// Window has to keep processing its events while idle, so the thread sleeps in GLFW instead.
+		// Input wakes it directly, RequestRedraw through an empty event
+		glfwWaitEventsTimeout(timeout.count());
+	}
 }
 
 void LGL::PauseRendering(bool value)
@@ -637,9 +1307,146 @@ void LGL::CreateRenderTextVO()
 }
 
 void LGL::CreateMesh(const std::string& modelName, MeshInfo& meshInfo)
+{
+	PreparedTextures preparedTextures;
+	PrepareTextures(&meshInfo, 1, preparedTextures);
+
+	CreateMeshImpl(modelName, meshInfo, &preparedTextures);
+}
+
+void LGL::CreateMeshImpl(
+	const std::string& modelName, MeshInfo& meshInfo, const PreparedTextures* preparedTextures, bool deferTextureUpload
+)
 {
 	HandshakeContextLock
 
+	if (internalModelMap.find(modelName) == internalModelMap.end())
+	{
+		assert(false && "Trying to add mesh to non existent model");
+		return;
+	}
+
+	if (uploadContext->IsRunning())
+	{
+		QueueMeshUpload(modelName, meshInfo);
+	}
+	else
+	{
+		VBO newVBO = 0;
+		EBO newEBO = 0;
+
+		CreateMeshBuffers(meshInfo.mesh.vert, meshInfo.mesh.indices, meshInfo.isDynamic, newVBO, newEBO);
+		CreateMeshVAO(internalModelMap[modelName], meshInfo, newVBO, newEBO);
+	}
+
+	LoadAndCompileShader(meshInfo.shaderProgram);
+	for (auto& texture : meshInfo.mesh.textures)
+	{
+		const PreparedTexture* preparedTexture = nullptr;
+
+		if (preparedTextures)
+		{
+			auto preparedIter = preparedTextures->find(texture.name);
+			preparedTexture = preparedIter != preparedTextures->end() ? &preparedIter->second : nullptr;
+		}
+
+		ConfigureTexture(modelName, texture, preparedTexture, deferTextureUpload);
+	}
+}
+
+// Registry keys of all textures of the meshes, mip chains and block compression of the ones uploaded right away.
+// Done before the handshake of the mesh or model creation, so rendering is not paused for hashing and import
+void LGL::PrepareTextures(MeshInfo* meshes, size_t meshAmount, PreparedTextures& preparedTextures)
+{
+	for (size_t meshIndex = 0; meshIndex < meshAmount; ++meshIndex)
+	{
+		for (auto& texture : meshes[meshIndex].mesh.textures)
+		{
+			if (texture.data && GetTextureFormat(texture.channelAmount) && !preparedTextures.contains(texture.name))
+			{
+				PreparedTexture& preparedTexture = preparedTextures[texture.name];
+				preparedTexture.texture = &texture;
+				preparedTexture.key = LGLTextureRegistry::GetKey(texture);
+			}
+		}
+	}
+
+	std::vector<PreparedTexture*> toImport;
+
+	{
+		// Shared textures and the ones uploaded by other threads are not imported here
+		ContextLock
+
+		if (asyncTextureUpload || uploadContext->IsRunning())
+		{
+			return;
+		}
+
+		for (auto& [_, preparedTexture] : preparedTextures)
+		{
+			const Texture& texture = *preparedTexture.texture;
+
+			if ((texture.params.createMipmaps || IsTextureCompressible(texture)) && 
+				!textureRegistry->IsRegistered(preparedTexture.key))
+			{
+				toImport.push_back(&preparedTexture);
+			}
+		}
+	}
+
+	for (PreparedTexture* preparedTexture : toImport)
+	{
+		const Texture& texture = *preparedTexture->texture;
+
+		preparedTexture->importedTexture = LGLTextureImporter::Import(
+			texture.data, 
+			texture.width, 
+			texture.height, 
+			texture.channelAmount, 
+			texture.params.createMipmaps, 
+			IsTextureCompressible(texture)
+		);
+		preparedTexture->imported = true;
+	}
+}
+
+// Buffers are filled through the copy target, so no VAO bound in the context is changed by it
+void LGL::CreateMeshBuffers(
+	const std::vector<Vertex>& vert, 
+	const std::vector<unsigned int>& indices, 
+	bool isDynamic, 
+	VBO& newVBO, 
+	EBO& newEBO
+)
+{
+	GLSafeExecute(glGenBuffers, 1, &newVBO);
+	GLSafeExecute(glBindBuffer, GL_COPY_WRITE_BUFFER, newVBO);
+	GLSafeExecute(
+		glBufferData,
+		GL_COPY_WRITE_BUFFER, 
+		vert.size() * sizeof(Vertex),
+		&vert[0],
+		isDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW
+	);
+
+	if (!indices.empty())
+	{
+		GLSafeExecute(glGenBuffers, 1, &newEBO);
+		GLSafeExecute(glBindBuffer, GL_COPY_WRITE_BUFFER, newEBO);
+		GLSafeExecute(
+			glBufferData,
+			GL_COPY_WRITE_BUFFER, 
+			indices.size() * sizeof(unsigned int),
+			&indices[0],
+			isDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW
+		);
+	}
+
+	GLSafeExecute(glBindBuffer, GL_COPY_WRITE_BUFFER, 0);
+}
+
+void LGL::CreateMeshVAO(InternalModelInfo& newVAOInfo, MeshInfo& meshInfo, VBO newVBO, EBO newEBO)
+{
 	auto CollectSteps = []() {
 		std::vector<size_t> steps;
 
@@ -656,14 +1463,6 @@ void LGL::CreateMesh(const std::string& modelName, MeshInfo& meshInfo)
 		return steps;
 	};
 
-	if (internalModelMap.find(modelName) == internalModelMap.end())
-	{
-		assert(false && "Trying to add mesh to non existent model");
-		return;
-	}
-
-	auto& newVAOInfo = internalModelMap[modelName];
-
 	std::vector<size_t> steps = CollectSteps();
 
 	newVAOInfo.VAOs.push_back({});
@@ -671,41 +1470,27 @@ void LGL::CreateMesh(const std::string& modelName, MeshInfo& meshInfo)
 	GLSafeExecute(glGenVertexArrays, 1, newVAO);
 	GLSafeExecute(glBindVertexArray, *newVAO);
 
-	VBOCollection.push_back(VBO());
-	VBO* newVBO = &VBOCollection.back();
+	VBOCollection.push_back(newVBO);
+	newVAOInfo.residentBytes += meshInfo.mesh.vert.size() * sizeof(Vertex);
 
-	GLSafeExecute(glGenBuffers, 1, newVBO);
-	GLSafeExecute(glBindBuffer, GL_ARRAY_BUFFER, *newVBO);
-	GLSafeExecute(
-		glBufferData,
-		GL_ARRAY_BUFFER, 
-		meshInfo.mesh.vert.size() * sizeof(Vertex),
-		&meshInfo.mesh.vert[0],
-		meshInfo.isDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW
-	);
+	GLSafeExecute(glBindBuffer, GL_ARRAY_BUFFER, newVBO);
 
 	if (!meshInfo.mesh.indices.empty())
 	{
-		EBOCollection.push_back(EBO());
-		EBO* newEBO = &EBOCollection.back();
+		EBOCollection.push_back(newEBO);
 
-		GLSafeExecute(glGenBuffers, 1, newEBO);
-		GLSafeExecute(glBindBuffer, GL_ELEMENT_ARRAY_BUFFER, *newEBO);
-		GLSafeExecute(
-			glBufferData,
-			GL_ELEMENT_ARRAY_BUFFER, 
-			meshInfo.mesh.indices.size() * sizeof(unsigned int),
-			&meshInfo.mesh.indices[0],
-			meshInfo.isDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW
-		);
+		GLSafeExecute(glBindBuffer, GL_ELEMENT_ARRAY_BUFFER, newEBO);
+		newVAOInfo.VAOs.back().ebo = newEBO;
 		newVAOInfo.VAOs.back().useIndices = true;
 		newVAOInfo.VAOs.back().pointAmount = meshInfo.mesh.indices.size();
+		newVAOInfo.residentBytes += meshInfo.mesh.indices.size() * sizeof(unsigned int);
 	}
 	else
 	{
 		newVAOInfo.VAOs.back().pointAmount = meshInfo.mesh.vert.size();
 	}
 
+	newVAOInfo.VAOs.back().vbo = newVBO;
 	newVAOInfo.VAOs.back().meshInfo = &meshInfo;
 
 
@@ -727,7 +1512,7 @@ void LGL::CreateMesh(const std::string& modelName, MeshInfo& meshInfo)
 	size_t byteOffset = 0;
 	for (int i = 0; i < steps.size(); ++i)
 	{
-		glEnableVertexAttribArray(i);
+		GLSafeExecute(glEnableVertexAttribArray, i);
 
 		if (i == 5)
 		{
@@ -747,17 +1532,84 @@ void LGL::CreateMesh(const std::string& modelName, MeshInfo& meshInfo)
 	//glBindVertexArray(0);
 
 	size_t polygons = newVAOInfo.VAOs.back().pointAmount / 3;
-	std::cout << "Mesh with " << newVAOInfo.VAOs.back().pointAmount << " point(s) / " << polygons << " polygons created\n";
+	std::clog << "Mesh with " << newVAOInfo.VAOs.back().pointAmount << " point(s) / " << polygons << " polygons created\n";
+}
 
-	LoadAndCompileShader(meshInfo.shaderProgram);
-	for (auto& texture : meshInfo.mesh.textures)
+// Meshes of a model are uploaded and completed in order, so VAOs keep the order of the meshes.
+// Uploads of a model deleted or evicted meanwhile are dropped by the generation of its buffers.
+// The loader thread works on its own copy of the mesh data, the mesh itself is looked up again on completion
+void LGL::QueueMeshUpload(const std::string& modelName, MeshInfo& meshInfo)
+{
+	auto& modelInfo = internalModelMap[modelName];
+	auto model = modelInfo.GetModelPtr();
+	size_t meshIndex = model ? model->meshes.size() : 0;
+
+	for (size_t i = 0; model && i < model->meshes.size(); ++i)
+	{
+		if (&model->meshes[i] == &meshInfo)
+		{
+			meshIndex = i;
+			break;
+		}
+	}
+
+	// Meshes outside of the model can not be looked up later, so they are uploaded right away
+	if (!model || meshIndex == model->meshes.size())
+	{
+		VBO newVBO = 0;
+		EBO newEBO = 0;
+
+		CreateMeshBuffers(meshInfo.mesh.vert, meshInfo.mesh.indices, meshInfo.isDynamic, newVBO, newEBO);
+		CreateMeshVAO(modelInfo, meshInfo, newVBO, newEBO);
+
+		return;
+	}
+
+	if (!modelInfo.bufferGeneration)
 	{
-		ConfigureTexture(modelName, texture);
+		modelInfo.bufferGeneration = ++lastBufferGeneration;
 	}
+
+	const size_t bufferGeneration = modelInfo.bufferGeneration;
+	auto buffers = std::make_shared<std::pair<VBO, EBO>>(0, 0);
+
+	uploadContext->Queue(
+		[buffers, vert = meshInfo.mesh.vert, indices = meshInfo.mesh.indices, isDynamic = bool(meshInfo.isDynamic)]()
+		{
+			CreateMeshBuffers(vert, indices, isDynamic, buffers->first, buffers->second);
+		},
+		[this, modelName, bufferGeneration, buffers, meshIndex]()
+		{
+			auto modelIter = internalModelMap.find(modelName);
+			bool isCurrent = modelIter != internalModelMap.end() && modelIter->second.bufferGeneration == bufferGeneration;
+			auto model = isCurrent ? modelIter->second.GetModelPtr() : nullptr;
+
+			if (!model || model->meshes.size() <= meshIndex)
+			{
+				GLSafeExecute(glDeleteBuffers, 1, &buffers->first);
+
+				if (buffers->second)
+				{
+					GLSafeExecute(glDeleteBuffers, 1, &buffers->second);
+				}
+
+				return;
+			}
+
+			CreateMeshVAO(modelIter->second, model->meshes[meshIndex], buffers->first, buffers->second);
+			redrawRequested = true;
+		}
+	);
 }
 
 void LGL::CreateModel(const std::string& modelName, LGLStructs::ModelInfo& model)
 {
+	PreparedTextures preparedTextures;
+	PrepareTextures(model.meshes.data(), model.meshes.size(), preparedTextures);
+
+	// Models are created from loading threads while the render thread walks the map
+	HandshakeContextLock
+
 	if (internalModelMap.find(modelName) == internalModelMap.end())
 	{
 		internalModelMap.emplace(modelName, InternalModelInfo{});
@@ -765,13 +1617,24 @@ void LGL::CreateModel(const std::string& modelName, LGLStructs::ModelInfo& model
 
 		for (auto& mesh : internalModelMap[modelName].GetModelPtr()->meshes)
 		{
-			CreateMesh(modelName, mesh);
+			CreateMeshImpl(modelName, mesh, &preparedTextures);
 		}
+
+		RequestRedraw();
 	}
 }
 
 void LGL::CreateModel(const std::string& modelName, std::weak_ptr<LGLStructs::ModelInfo> model)
 {
+	PreparedTextures preparedTextures;
+
+	if (auto modelPtr = model.lock())
+	{
+		PrepareTextures(modelPtr->meshes.data(), modelPtr->meshes.size(), preparedTextures);
+	}
+
+	HandshakeContextLock
+
 	if (internalModelMap.find(modelName) == internalModelMap.end())
 	{
 		internalModelMap.emplace(modelName, InternalModelInfo{});
@@ -779,9 +1642,69 @@ void LGL::CreateModel(const std::string& modelName, std::weak_ptr<LGLStructs::Mo
 
 		for (auto& mesh : internalModelMap[modelName].GetModelPtr()->meshes)
 		{
-			CreateMesh(modelName, mesh);
+			CreateMeshImpl(modelName, mesh, &preparedTextures);
+		}
+
+		RequestRedraw();
+	}
+}
+
+std::future<void> LGL::CreateModelAsync(const std::string& modelName, std::weak_ptr<LGLStructs::ModelInfo> model)
+{
+	auto modelPtr = model.lock();
+
+	if (!modelPtr)
+	{
+		std::promise<void> noModel;
+		noModel.set_value();
+
+		return noModel.get_future();
+	}
+
+	// Textures are imported by the calling thread, commands only upload them
+	auto preparedTextures = std::make_shared<PreparedTextures>();
+	PrepareTextures(modelPtr->meshes.data(), modelPtr->meshes.size(), *preparedTextures);
+
+	// Meshes are not added to a model which existed before the first command or was deleted after it
+	auto modelAdded = std::make_shared<bool>(false);
+
+	std::future<void> result = ExecuteOnRenderThread([this, modelName, model, modelAdded]()
+	{
+		if (internalModelMap.find(modelName) == internalModelMap.end())
+		{
+			internalModelMap.emplace(modelName, InternalModelInfo{});
+			internalModelMap[modelName].SetModelPtr(model);
+			*modelAdded = true;
 		}
+	});
+
+	for (size_t meshIndex = 0; meshIndex < modelPtr->meshes.size(); ++meshIndex)
+	{
+		result = ExecuteOnRenderThread([this, modelName, meshIndex, modelAdded, preparedTextures]()
+		{
+			auto modelIter = internalModelMap.find(modelName);
+
+			if (!*modelAdded || modelIter == internalModelMap.end())
+			{
+				return;
+			}
+
+			auto currentModel = modelIter->second.GetModelPtr();
+
+			if (currentModel && meshIndex < currentModel->meshes.size())
+			{
+				CreateMeshImpl(modelName, currentModel->meshes[meshIndex], preparedTextures.get());
+				RequestRedraw();
+			}
+		});
 	}
+
+	return result;
+}
+
+std::future<void> LGL::DeleteModelAsync(const std::string& modelName)
+{
+	return ExecuteOnRenderThread([this, modelName]() { DeleteModel(modelName); });
 }
 
 void LGL::CreateText(const std::string& textLabel, LGLStructs::TextInfo& text)
@@ -804,6 +1727,8 @@ void LGL::CreateText(const std::string& textLabel, LGLStructs::TextInfo& text)
 	}
 
 	internalTextMap[textLabel] = &text;
+
+	RequestRedraw();
 }
 
 void LGL::DeleteModel(const std::string& modelName)
@@ -812,19 +1737,141 @@ void LGL::DeleteModel(const std::string& modelName)
 
 	if(internalModelMap.find(modelName) != internalModelMap.end())
 	{
-		GLSafeExecute(glBindVertexArray, 0);
+		ReleaseModelBuffers(internalModelMap[modelName]);
+		ReleaseModelTextures(internalModelMap[modelName]);
+
+		textureStreamer->RemoveModelScreenSize(modelName);
+		internalModelMap.erase(modelName);
+	}
+
+	RequestRedraw();
+}
+
+void LGL::EvictModel(const std::string& modelName)
+{
+	HandshakeContextLock
 
-		for (auto& VAO : internalModelMap[modelName].VAOs)
+	auto modelIter = internalModelMap.find(modelName);
+
+	if (modelIter == internalModelMap.end() || !modelIter->second.resident)
+	{
+		return;
+	}
+
+	const size_t releasedBytes = modelIter->second.residentBytes;
+
+	for (auto& [textureName, sharedTexture] : modelIter->second.sharedTextures)
+	{
+		modelIter->second.evictedTextureKeys[textureName] = sharedTexture.key;
+	}
+
+	ReleaseModelBuffers(modelIter->second);
+	ReleaseModelTextures(modelIter->second);
+	modelIter->second.residentBytes = 0;
+	modelIter->second.resident = false;
+
+	std::cout << "Model " << modelName << " evicted from GPU, released " << releasedBytes / 1024 << " KB\n";
+}
+
+bool LGL::IsModelResident(const std::string& modelName)
+{
+	ContextLock
+
+	auto modelIter = internalModelMap.find(modelName);
+
+	return modelIter != internalModelMap.end() && modelIter->second.resident;
+}
+
+size_t LGL::GetResidentModelBytes()
+{
+	ContextLock
+
+	size_t res = 0;
+
+	for (auto& [_, modelInfo] : internalModelMap)
+	{
+		res += modelInfo.residentBytes;
+	}
+
+	return res;
+}
+
+// Buffers are removed from the collections too, so DeleteGLObjects does not delete names reused since
+void LGL::ReleaseModelBuffers(InternalModelInfo& modelInfo)
+{
+	GLSafeExecute(glBindVertexArray, 0);
+
+	for (auto& VAO : modelInfo.VAOs)
+	{
+		GLSafeExecute(glDeleteVertexArrays, 1, &VAO.vboId);
+		GLSafeExecute(glDeleteBuffers, 1, &VAO.vbo);
+		std::erase(VBOCollection, VAO.vbo);
+
+		if (VAO.useIndices)
 		{
-			GLSafeExecute(glDeleteVertexArrays, 1, &VAO.vboId);
+			GLSafeExecute(glDeleteBuffers, 1, &VAO.ebo);
+			std::erase(EBOCollection, VAO.ebo);
 		}
-		for (auto& texture : internalModelMap[modelName].textureIDs)
+	}
+
+	modelInfo.VAOs.clear();
+	modelInfo.bufferGeneration = 0;
+}
+
+// Render thread. Meshes are recreated by render commands within the command budget of the following frames,
+// textures are imported by the uploader worker and uploaded within the texture budget
+void LGL::RestoreModel(const std::string& modelName, InternalModelInfo& modelInfo)
+{
+	const size_t meshAmount = modelInfo.GetModelPtr()->meshes.size();
+
+	auto preparedTextures = std::make_shared<PreparedTextures>();
+
+	for (auto& [textureName, textureKey] : modelInfo.evictedTextureKeys)
+	{
+		(*preparedTextures)[textureName].key = textureKey;
+	}
+
+	modelInfo.evictedTextureKeys.clear();
+	modelInfo.restorePending = true;
+
+	for (size_t meshIndex = 0; meshIndex < meshAmount; ++meshIndex)
+	{
+		commandQueue->Push([this, modelName, meshIndex, meshAmount, preparedTextures]()
 		{
-			GLSafeExecute(glDeleteTextures, 1, &texture.second);
-		}
+			auto modelIter = internalModelMap.find(modelName);
 
-		internalModelMap.erase(modelName);
+			// Deleted, or deleted and created again meanwhile
+			if (modelIter == internalModelMap.end() || !modelIter->second.restorePending)
+			{
+				return;
+			}
+
+			auto currentModel = modelIter->second.GetModelPtr();
+
+			if (currentModel && meshIndex < currentModel->meshes.size())
+			{
+				CreateMeshImpl(modelName, currentModel->meshes[meshIndex], preparedTextures.get(), true);
+			}
+
+			if (meshIndex + 1 == meshAmount)
+			{
+				modelIter->second.restorePending = false;
+				modelIter->second.resident = true;
+				redrawRequested = true;
+
+				std::cout << "Model " << modelName << " restored on GPU\n";
+			}
+		});
+	}
+
+	if (!meshAmount)
+	{
+		modelInfo.restorePending = false;
+		modelInfo.resident = true;
 	}
+
+	// Commands pushed after this frame's ones were executed, the next frame has to run them
+	redrawRequested = true;
 }
 
 void LGL::DeleteText(const std::string& textLabel)
@@ -834,6 +1881,7 @@ void LGL::DeleteText(const std::string& textLabel)
 	if (internalTextMap.find(textLabel) != internalTextMap.end())
 	{
 		internalTextMap.erase(textLabel);
+		RequestRedraw();
 	}
 }
 
@@ -999,202 +2047,587 @@ void LGL::GetMeshFromFile(const std::string& file, std::vector<Vertex>& vertexes
 		}
 	};
 
-	stdEx::map<int, std::function<void()>> processFileFuncs;
-	processFileFuncs[1] = CheckVertexVectors;
-	processFileFuncs[2] = CheckIndecesAndFormResult;
-	processFileFuncs.SetDefaultValue([](){});
+	stdEx::map<int, std::function<void()>> processFileFuncs;
+	processFileFuncs[1] = CheckVertexVectors;
+	processFileFuncs[2] = CheckIndecesAndFormResult;
+	processFileFuncs.SetDefaultValue([](){});
+
+	while (std::getline(reader, line))
+	{
+		CheckForFileSectionChange();
+		processFileFuncs.at(fileSection)();
+	}
+
+	vertexes = resVertexes;
+	indeces = resIndeces;
+}
+#endif
+
+bool LGL::CompileShader(ShaderType shaderType, const std::string& name)
+{
+	using AcceptableShaderCode = const char* const;
+
+	HandshakeContextLock
+
+	if (shaderInfoCollection.find(name) == shaderInfoCollection.end())
+	{
+		std::cerr << "Shader " + name + "not found\n";
+		return false;
+	}
+
+	ShaderInfo& currentShaderInfo = shaderInfoCollection[name].second[shaderType];
+	AcceptableShaderCode shaderToC = currentShaderInfo.shaderCode.c_str();
+
+	ShaderID* newShader = &currentShaderInfo.shaderId;
+
+	GLSafeExecute(glShaderSource, *newShader, 1, &shaderToC, nullptr);
+	bool shaderCompiled = GLSafeExecute(glCompileShader, *newShader);
+
+	return shaderCompiled;
+}
+
+bool LGL::LoadShaderFromFile(const std::string& name, const std::string& file, const std::string& shaderType)
+{
+	HandshakeContextLock
+
+	ShaderType shaderTypeID = shaderTypeChoice[shaderType];
+	std::string shader; // change to stringstream
+	std::string line;
+
+	std::ifstream reader(file);
+
+	if (!reader)
+	{
+		std::cout << name + '.' + shaderType + " shader does not exist\n";
+		return false;
+	}
+
+	while (std::getline(reader, line))
+	{
+		shader += (line + '\n');
+	}
+
+	shaderInfoCollection[name].second.emplace(
+		shaderTypeID,
+		ShaderInfo{
+			GLSafeExecuteRet(glCreateShader, shaderTypeID),
+			shader
+		}
+	);
+
+	std::cout << "Shader " << name + '.' + shaderType << " loaded\n";
+
+	return true;
+}
+
+LGL::ShaderProgramID LGL::SetCurrentShaderProg(const std::string& shaderProg)
+{
+	ShaderProgramID shaderProgID = ~ShaderProgramID{};
+	if (shaderInfoCollection.find(shaderProg) != shaderInfoCollection.end())
+	{
+		shaderProgID = shaderInfoCollection[shaderProg].first;
+
+		if (lastProgram != shaderProg)
+		{
+			lastProgram = shaderProg;
+			GLSafeExecute(glUseProgram, shaderProgID);
+		}
+	}
+
+	return shaderProgID;
+}
+
+unsigned int LGL::GetTextureFormat(int channelAmount)
+{
+	switch (channelAmount)
+	{
+	case 1:
+		return GL_RED;
+	case 3:
+		return GL_RGB;
+	case 4:
+		return GL_RGBA;
+	default:
+		return 0;
+	}
+}
+
+bool LGL::IsTextureCompressible(const Texture& texture)
+{
+	return texture.params.compress && textureCompressionSupported &&
+		LGLTextureImporter::GetBlockFormat(texture.channelAmount) != LGLTextureImporter::BlockFormat::None;
+}
+
+void LGL::SetTextureParams(const Texture::TextureParams& params, int maxLevel)
+{
+	GLSafeExecute(
+		glTexParameteri,
+		GL_TEXTURE_2D, 
+		GL_TEXTURE_WRAP_S, 
+		LGLEnumInterpreter::TextureOverlayTypeInter[static_cast<int>(params.overlay)]
+	);
+	GLSafeExecute(
+		glTexParameteri,
+		GL_TEXTURE_2D, 
+		GL_TEXTURE_WRAP_T, 
+		LGLEnumInterpreter::TextureOverlayTypeInter[static_cast<int>(params.overlay)]
+	);
+
+	//GLSafeExecute(glTexParameterfv, GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, color);
+	int glParams[]{ GL_LINEAR, GL_NEAREST };
+
+	if (maxLevel > 0) 
+	{
+		// Texel filter by BFConfig, filter between mip levels by mipmapBFConfig. Linear for both is trilinear
+		int glMipParams[2][2]
+		{
+			{ GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR_MIPMAP_NEAREST },
+			{ GL_NEAREST_MIPMAP_LINEAR, GL_NEAREST_MIPMAP_NEAREST}
+		};
+
+		GLSafeExecute(
+			glTexParameteri,
+			GL_TEXTURE_2D, 
+			GL_TEXTURE_MIN_FILTER, 
+			glMipParams[params.BFConfig.minFilter][params.mipmapBFConfig.minFilter]
+		);
+	}
+	else
+	{
+		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glParams[params.BFConfig.minFilter]);
+	}
+
+	GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glParams[params.BFConfig.maxFilter]);
+	GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+}
+
+bool LGL::ConfigureTextureImpl(
+	TextureID& newTextureID, const Texture& texture, bool loaderThread, const PreparedTexture* preparedTexture
+)
+{
+	unsigned int textureFormat = GetTextureFormat(texture.channelAmount);
+
+	if (!textureFormat)
+	{
+		std::cout << "Unknown format\n";
+		return false;
+	}
+
+	const bool compress = IsTextureCompressible(texture);
+	const bool import = texture.data && (texture.params.createMipmaps || compress);
+
+	// Textures of models are imported by PrepareTextures before the model takes the context,
+	// the rest are imported here, which is before the context is taken only if the caller does not hold it
+	LGLTextureImporter::ImportedTexture localImport;
+	const LGLTextureImporter::ImportedTexture* importedTexture = &localImport;
+
+	if (import && preparedTexture && preparedTexture->imported)
+	{
+		importedTexture = &preparedTexture->importedTexture;
+	}
+	else if (import)
+	{
+		localImport = LGLTextureImporter::Import(
+			texture.data, texture.width, texture.height, texture.channelAmount, texture.params.createMipmaps, compress
+		);
+	}
+
+	auto UploadTexture = [&]()
+	{
+		GLSafeExecute(glGenTextures, 1, &newTextureID);
+		GLSafeExecute(glBindTexture, GL_TEXTURE_2D, newTextureID);
+
+		SetTextureParams(texture.params, import ? static_cast<int>(importedTexture->mips.size()) - 1 : 0);
+
+		GLSafeExecute(glPixelStorei, GL_UNPACK_ALIGNMENT, textureFormat != GL_RGBA ? 1 : 4);
+
+		if (import)
+		{
+			for (size_t level = 0; level < importedTexture->mips.size(); ++level)
+			{
+				const auto& mip = importedTexture->mips[level];
+
+				if (compress)
+				{
+					GLSafeExecute(
+						glCompressedTexImage2D, GL_TEXTURE_2D, static_cast<int>(level), 
+						LGLTextureImporter::GetGLFormat(importedTexture->format), mip.width, mip.height, 0,
+						static_cast<int>(mip.data.size()), mip.data.data()
+					);
+				}
+				else
+				{
+					GLSafeExecute(
+						glTexImage2D, GL_TEXTURE_2D, static_cast<int>(level), textureFormat, mip.width, mip.height, 0, 
+						textureFormat, GL_UNSIGNED_BYTE, mip.data.data()
+					);
+				}
+			}
+		}
+		else
+		{
+			GLSafeExecute(
+				glTexImage2D, GL_TEXTURE_2D, 0, textureFormat, texture.width, texture.height, 0, textureFormat, 
+				GL_UNSIGNED_BYTE, texture.data
+			);
+		}
+	};
+
+	// Loader thread has its own context set, the one of the render thread is not taken
+	if (loaderThread)
+	{
+		UploadTexture();
+	}
+	else
+	{
+		HandshakeContextLock
+
+		UploadTexture();
+	}
+
+	std::clog << 
+		"Texture " << texture.name << " configured" << 
+		(import ? ", mip levels: " + std::to_string(importedTexture->mips.size()) : "") << 
+		(compress ? ", block compressed" : "") << '\n';
+
+	return true;
+}
+
+void LGL::CreatePlaceholderTexture()
+{
+	HandshakeContextLock
+
+	const unsigned char white[]{ 255, 255, 255, 255 };
+
+	GLSafeExecute(glGenTextures, 1, &placeholderTexture);
+	GLSafeExecute(glBindTexture, GL_TEXTURE_2D, placeholderTexture);
+	SetTextureParams({}, 0);
+	GLSafeExecute(glTexImage2D, GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+	GLSafeExecute(glBindTexture, GL_TEXTURE_2D, 0);
+}
+
+bool LGL::ConfigureTexture(const std::string& modelName, const LGLStructs::Texture& texture)
+{
+	return ConfigureTexture(modelName, texture, nullptr);
+}
+
+bool LGL::ConfigureTexture(
+	const std::string& modelName, const Texture& texture, const PreparedTexture* preparedTexture, bool deferUpload
+)
+{
+	if (internalModelMap[modelName].textureIDs.find(texture.name) != internalModelMap[modelName].textureIDs.end())
+	{
+		return true;
+	}
+
+	if (texture.data)
+	{
+		internalModelMap[modelName].residentBytes += 
+			LGLTextureRegistry::GetVRAMSize(texture, IsTextureCompressible(texture));
+	}
 
-	while (std::getline(reader, line))
+	if (!texture.data || !GetTextureFormat(texture.channelAmount))
 	{
-		CheckForFileSectionChange();
-		processFileFuncs.at(fileSection)();
+		internalModelMap[modelName].textureIDs[texture.name] = TextureID();
+
+		return ConfigureTextureImpl(internalModelMap[modelName].textureIDs[texture.name], texture);
 	}
 
-	vertexes = resVertexes;
-	indeces = resIndeces;
-}
-#endif
+	// Identical textures of different models share a single GL texture
+	const size_t textureKey = preparedTexture ? preparedTexture->key : LGLTextureRegistry::GetKey(texture);
+	const bool compress = IsTextureCompressible(texture);
 
-bool LGL::CompileShader(ShaderType shaderType, const std::string& name)
-{
-	using AcceptableShaderCode = const char* const;
+	if (auto sharedTextureID = textureRegistry->Acquire(textureKey, texture))
+	{
+		internalModelMap[modelName].sharedTextures[texture.name] = { textureKey, &texture };
+		internalModelMap[modelName].textureIDs[texture.name] = *sharedTextureID;
 
-	HandshakeContextLock
+		std::clog << 
+			"Texture " << texture.name << " shared, VRAM saved by sharing: " << 
+			textureRegistry->GetSavedBytes() / 1024 << " KB\n";
 
-	if (shaderInfoCollection.find(name) == shaderInfoCollection.end())
+		return true;
+	}
+
+	// Different texture with the same key, uploaded as a texture of this model only
+	if (textureRegistry->IsRegistered(textureKey))
 	{
-		std::cerr << "Shader " + name + "not found\n";
-		return false;
+		internalModelMap[modelName].textureIDs[texture.name] = TextureID();
+
+		return ConfigureTextureImpl(internalModelMap[modelName].textureIDs[texture.name], texture);
 	}
 
-	ShaderInfo& currentShaderInfo = shaderInfoCollection[name].second[shaderType];
-	AcceptableShaderCode shaderToC = currentShaderInfo.shaderCode.c_str();
+	internalModelMap[modelName].sharedTextures[texture.name] = { textureKey, &texture };
 
-	ShaderID* newShader = &currentShaderInfo.shaderId;
+	if (asyncTextureUpload || (deferUpload && !uploadContext->IsRunning()))
+	{
+		if (!placeholderTexture)
+		{
+			CreatePlaceholderTexture();
+		}
 
-	GLSafeExecute(glShaderSource, *newShader, 1, &shaderToC, nullptr);
-	bool shaderCompiled = GLSafeExecute(glCompileShader, *newShader);
+		// Placeholder is bound instead of the texture until the render loop uploads it
+		internalModelMap[modelName].textureIDs[texture.name] = placeholderTexture;
+		textureRegistry->Register(textureKey, placeholderTexture, LGLTextureRegistry::GetVRAMSize(texture, compress), texture);
+		textureUploader->Queue(modelName, texture, textureKey, compress);
 
-	return shaderCompiled;
-}
+		return true;
+	}
 
-bool LGL::LoadShaderFromFile(const std::string& name, const std::string& file, const std::string& shaderType)
-{
-	HandshakeContextLock
+	if (uploadContext->IsRunning())
+	{
+		QueueTextureUpload(modelName, texture, textureKey, compress);
 
-	ShaderType shaderTypeID = shaderTypeChoice[shaderType];
-	std::string shader; // change to stringstream
-	std::string line;
+		return true;
+	}
 
-	std::ifstream reader(file);
+	internalModelMap[modelName].textureIDs[texture.name] = TextureID();
 
-	if (!reader)
+	TextureID& newTextureID = internalModelMap[modelName].textureIDs[texture.name];
+
+	if (!ConfigureTextureImpl(newTextureID, texture, false, preparedTexture))
 	{
-		std::cout << name + '.' + shaderType + " shader does not exist\n";
 		return false;
 	}
 
-	while (std::getline(reader, line))
+	textureRegistry->Register(textureKey, newTextureID, LGLTextureRegistry::GetVRAMSize(texture, compress), texture);
+
+	return true;
+}
+
+// Same placeholder as for async upload is bound until the loader thread finishes the texture
+void LGL::QueueTextureUpload(const std::string& modelName, const Texture& texture, size_t textureKey, bool compress)
+{
+	if (!placeholderTexture)
 	{
-		shader += (line + '\n');
+		CreatePlaceholderTexture();
 	}
 
-	shaderInfoCollection[name].second.emplace(
-		shaderTypeID,
-		ShaderInfo{
-			GLSafeExecuteRet(glCreateShader, shaderTypeID),
-			shader
-		}
+	internalModelMap[modelName].textureIDs[texture.name] = placeholderTexture;
+	textureRegistry->Register(textureKey, placeholderTexture, LGLTextureRegistry::GetVRAMSize(texture, compress), texture);
+
+	// Texture data is copied, the model may be gone before the loader gets to it
+	std::vector<unsigned char> sourceData(
+		texture.data, texture.data + static_cast<size_t>(texture.width) * texture.height * texture.channelAmount
 	);
+	auto newTextureID = std::make_shared<TextureID>(0);
 
-	std::cout << "Shader " << name + '.' + shaderType << " loaded\n";
+	uploadContext->Queue(
+		[this, loadedTexture = texture, sourceData = std::move(sourceData), newTextureID]() mutable
+		{
+			loadedTexture.data = sourceData.data();
+			ConfigureTextureImpl(*newTextureID, loadedTexture, true);
+		},
+		[this, textureKey, newTextureID]()
+		{
+			// Texture was released by all of its models meanwhile
+			if (!ReplacePlaceholderTexture(textureKey, *newTextureID))
+			{
+				GLSafeExecute(glDeleteTextures, 1, newTextureID.get());
+			}
 
-	return true;
+			redrawRequested = true;
+		}
+	);
 }
 
-LGL::ShaderProgramID LGL::SetCurrentShaderProg(const std::string& shaderProg)
+// Every model sharing the texture had the placeholder bound. False if the texture is not registered anymore
+bool LGL::ReplacePlaceholderTexture(size_t textureKey, TextureID textureID)
 {
-	ShaderProgramID shaderProgID = ~ShaderProgramID{};
-	if (shaderInfoCollection.find(shaderProg) != shaderInfoCollection.end())
+	if (!textureRegistry->UpdateID(textureKey, textureID))
 	{
-		shaderProgID = shaderInfoCollection[shaderProg].first;
+		return false;
+	}
 
-		if (lastProgram != shaderProg)
+	for (auto& [_, modelInfo] : internalModelMap)
+	{
+		for (auto& [textureName, sharedTexture] : modelInfo.sharedTextures)
 		{
-			lastProgram = shaderProg;
-			GLSafeExecute(glUseProgram, shaderProgID);
+			if (sharedTexture.key == textureKey)
+			{
+				modelInfo.textureIDs[textureName] = textureID;
+			}
 		}
 	}
 
-	return shaderProgID;
+	return true;
 }
 
-bool LGL::ConfigureTextureImpl(TextureID& newTextureID, const Texture& texture)
+// Shared textures are deleted with the last model using them, if still being uploaded, the upload is cancelled
+void LGL::ReleaseModelTextures(InternalModelInfo& modelInfo)
 {
-	HandshakeContextLock
+	for (auto& [textureName, textureID] : modelInfo.textureIDs)
+	{
+		auto sharedTextureIter = modelInfo.sharedTextures.find(textureName);
+		TextureID textureToDelete = textureID;
 
-	GLSafeExecute(glGenTextures, 1, &newTextureID);
-	GLSafeExecute(glBindTexture, GL_TEXTURE_2D, newTextureID);
+		if (sharedTextureIter != modelInfo.sharedTextures.end())
+		{
+			auto releasedTextureID = textureRegistry->Release(sharedTextureIter->second.key, sharedTextureIter->second.texture);
 
-	float color[] {
-		texture.params.color.r,
-		texture.params.color.g,
-		texture.params.color.b,
-		texture.params.color.a,
-	};
-	
-	GLSafeExecute(
-		glTexParameteri,
-		GL_TEXTURE_2D, 
-		GL_TEXTURE_WRAP_S, 
-		LGLEnumInterpreter::TextureOverlayTypeInter[static_cast<int>(texture.params.overlay)]
-	);
-	GLSafeExecute(
-		glTexParameteri,
-		GL_TEXTURE_2D, 
-		GL_TEXTURE_WRAP_T, 
-		LGLEnumInterpreter::TextureOverlayTypeInter[static_cast<int>(texture.params.overlay)]
-	);
+			if (!releasedTextureID)
+			{
+				continue;
+			}
 
-	//GLSafeExecute(glTexParameterfv, GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, color);
-	if (texture.params.createMipmaps) 
-	{
-		int glMipParams[2][2]
-		{
-			{ GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR_MIPMAP_NEAREST },
-			{ GL_NEAREST_MIPMAP_LINEAR, GL_NEAREST_MIPMAP_NEAREST}
-		};
+			textureToDelete = *releasedTextureID;
 
-		GLSafeExecute(
-			glTexParameteri,
-			GL_TEXTURE_2D, 
-			GL_TEXTURE_MIN_FILTER, 
-			GL_NEAREST_MIPMAP_NEAREST//glMipParams[texture.params.mipmapBFConfig.minFilter][texture.params.BFConfig.minFilter]
-		);
-		GLSafeExecute(
-			glTexParameteri,
-			GL_TEXTURE_2D,
-			GL_TEXTURE_MAG_FILTER,
-			GL_NEAREST//glMipParams[texture.params.mipmapBFConfig.maxFilter][texture.params.BFConfig.maxFilter]
-		);
+			if (textureToDelete == placeholderTexture)
+			{
+				textureUploader->Cancel(sharedTextureIter->second.key);
+			}
+		}
 
-		GLSafeExecute(glGenerateMipmap, GL_TEXTURE_2D);
+		if (textureToDelete != placeholderTexture)
+		{
+			textureStreamer->Remove(textureToDelete);
+			GLSafeExecute(glDeleteTextures, 1, &textureToDelete);
+		}
 	}
-	else
-	{
-		int glParams[]{ GL_LINEAR, GL_NEAREST };
 
-		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glParams[texture.params.BFConfig.minFilter]);
-		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glParams[texture.params.BFConfig.maxFilter]);
-	}
+	modelInfo.textureIDs.clear();
+	modelInfo.sharedTextures.clear();
+}
+
+void LGL::EnableAsyncTextureUpload(bool value, size_t bytesPerFrame, float msPerFrame)
+{
+	asyncTextureUpload = value;
+	textureUploadBytesPerFrame = bytesPerFrame;
+	textureUploadMsPerFrame = msPerFrame;
+
+	std::cout << "Async texture upload has been set to " << value << '\n';
+}
 
-	//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	//glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void LGL::EnableTextureStreaming(bool value, size_t vramBudgetBytes)
+{
+	ContextLock
 
-	unsigned int textureFormat;
+	textureStreaming = value;
+	textureStreamer->SetBudget(vramBudgetBytes);
 
-	switch (texture.channelAmount)
+	if (value)
 	{
-	case 1:
-		textureFormat = GL_RED;
-		break;
-	case 3:
-		textureFormat = GL_RGB;
-		break;
-	case 4:
-		textureFormat = GL_RGBA;
-		break;
-	default:
-		std::cout << "Unknown format\n";
-		return false;
+		asyncTextureUpload = true;
 	}
 
-	GLSafeExecute(glPixelStorei, GL_UNPACK_ALIGNMENT, textureFormat != GL_RGBA ? 1 : 4);
-
-	GLSafeExecute(
-		glTexImage2D, GL_TEXTURE_2D, 0, textureFormat, texture.width, texture.height, 0, textureFormat, 
-		GL_UNSIGNED_BYTE, texture.data
-	);
+	std::cout << "Texture streaming has been set to " << value << ", budget: " << vramBudgetBytes / (1024 * 1024) << " MB\n";
+}
 
-	std::cout << "Texture " << texture.name << " configured\n";
+void LGL::SetModelScreenSize(const std::string& modelName, float screenSize)
+{
+	ContextLock
 
-	return true;
+	textureStreamer->SetModelScreenSize(modelName, screenSize);
 }
 
-bool LGL::ConfigureTexture(const std::string& modelName, const LGLStructs::Texture& texture)
+// Uploads prepared textures by row strips, stops once either the byte or the time budget is spent
+// At least one strip is uploaded per frame, so uploads are not stuck with a budget smaller than a strip
+void LGL::ProcessTextureUploads()
 {
-	if (internalModelMap[modelName].textureIDs.find(texture.name) != internalModelMap[modelName].textureIDs.end())
+	std::chrono::steady_clock::time_point uploadStartTime = std::chrono::steady_clock::now();
+	size_t uploadedBytes = 0;
+
+	while (auto job = textureUploader->GetReadyJob())
 	{
-		return true;
-	}
+		if (job->cancelled)
+		{
+			if (job->textureID)
+			{
+				GLSafeExecute(glDeleteTextures, 1, &job->textureID);
+			}
 
-	internalModelMap[modelName].textureIDs[texture.name] = TextureID();
+			textureUploader->PopReadyJob();
+			continue;
+		}
 
-	TextureID& newTextureID = internalModelMap[modelName].textureIDs[texture.name];
+		// Placeholder is replaced once the upload is finished, which has to be shown
+		redrawRequested = true;
+
+		auto& mips = job->importedTexture.mips;
+		const unsigned int textureFormat = GetTextureFormat(job->channelAmount);
+
+		if (!job->textureID)
+		{
+			GLSafeExecute(glGenTextures, 1, &job->textureID);
+			GLSafeExecute(glBindTexture, GL_TEXTURE_2D, job->textureID);
+			SetTextureParams(job->params, static_cast<int>(mips.size()) - 1);
+
+			// Only the low resolution levels are uploaded here, finer ones are left to the streamer
+			if (textureStreaming)
+			{
+				job->firstLevel = LGLTextureStreamer::GetInitialLevel(job->importedTexture);
+				job->currentLevel = job->firstLevel;
+				GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<int>(job->firstLevel));
+			}
+		}
+		else
+		{
+			GLSafeExecute(glBindTexture, GL_TEXTURE_2D, job->textureID);
+		}
+
+		const auto& mip = mips[job->currentLevel];
+		const size_t budgetLeft = 
+			textureUploadBytesPerFrame > uploadedBytes ? textureUploadBytesPerFrame - uploadedBytes : 0;
+
+		uploadedBytes += textureUploader->UploadMipRows(
+			mip, 
+			static_cast<int>(job->currentLevel), 
+			job->importedTexture.format, 
+			textureFormat, 
+			job->currentRow, 
+			budgetLeft
+		);
+
+		if (job->currentRow >= mip.height)
+		{
+			job->currentRow = 0;
+			++job->currentLevel;
+		}
+
+		if (job->currentLevel == mips.size())
+		{
+			const size_t uploadedLevels = mips.size() - job->firstLevel;
+			const bool placeholderReplaced = ReplacePlaceholderTexture(job->textureKey, job->textureID);
+
+			if (placeholderReplaced)
+			{
+				if (textureStreaming)
+				{
+					textureStreamer->Add(
+						job->textureID, 
+						job->modelName, 
+						textureFormat, 
+						std::move(job->importedTexture), 
+						static_cast<int>(job->firstLevel)
+					);
+				}
+			}
+			else
+			{
+				GLSafeExecute(glDeleteTextures, 1, &job->textureID);
+			}
+
+			std::clog << 
+				"Texture " << job->textureName << " uploaded, mip levels: " << uploadedLevels << 
+				(job->firstLevel ? " (rest is streamed)" : "") << '\n';
+			textureUploader->PopReadyJob();
+		}
 
-	return ConfigureTextureImpl(newTextureID, texture);
+		float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - uploadStartTime).count();
+
+		if (uploadedBytes >= textureUploadBytesPerFrame || elapsedMs >= textureUploadMsPerFrame)
+		{
+			break;
+		}
+	}
+
+	// Streaming shares the byte budget, finished uploads go first
+	if (textureStreaming && uploadedBytes < textureUploadBytesPerFrame)
+	{
+		textureStreamer->Process(*textureUploader, textureUploadBytesPerFrame - uploadedBytes);
+	}
+
+	GLSafeExecute(glBindTexture, GL_TEXTURE_2D, 0);
 }
 
 void LGL::ProduceTextTexAtlas(const LGLStructs::GlyphInfo& glyphInfo, AtlasInfo& atlasInfo)
@@ -1269,6 +2702,11 @@ void LGL::RecompileShader(const std::string& shaderName)
 	LoadAndCompileShader(shaderName);
 }
 
+std::future<void> LGL::RecompileShaderAsync(const std::string& shaderName)
+{
+	return ExecuteOnRenderThread([this, shaderName]() { RecompileShader(shaderName); });
+}
+
 void LGL::DeleteShader(const std::string& shaderName)
 {
 	lastProgram.clear();
@@ -1300,6 +2738,13 @@ void LGL::UpdateWindowSize(int width, int height)
 
 void LGL::ResetLGL()
 {
+	{
+		ContextLock
+
+		// Nothing created by queued commands outlives the reset
+		commandQueue->Execute();
+	}
+
 	DeleteGLObjects();
 }
 
@@ -1388,9 +2833,10 @@ void LGL::CursorPositionCallback(GLFWwindow* window, double xpos, double ypos)
 {
 	LGL* instance = CheckAndGetInstanceByContext(window);
 
-	if (instance && instance->cursorPositionFunc)
+	if (instance)
 	{
-		instance->cursorPositionFunc(xpos, ypos);
+		instance->redrawRequested = true;
+		instance->inputState->OnCursorPosition(xpos, ypos);
 	}
 }
 
@@ -1398,9 +2844,10 @@ void LGL::ScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 {
 	LGL* instance = CheckAndGetInstanceByContext(window);
 
-	if (instance && instance->scrollCallbackFunc)
+	if (instance)
 	{
-		instance->scrollCallbackFunc(xoffset, yoffset);
+		instance->redrawRequested = true;
+		instance->inputState->OnScroll(xoffset, yoffset);
 	}
 }
 
@@ -1408,9 +2855,26 @@ void LGL::KeyPressCallback(GLFWwindow* window, int key, int scancode, int action
 {
 	LGL* instance = CheckAndGetInstanceByContext(window);
 
-	if (instance && instance->keyPressCallbackFunc)
+	if (instance)
+	{
+		instance->redrawRequested = true;
+		instance->inputState->OnKey(key, action);
+
+		if (instance->keyPressCallbackFunc)
+		{
+			instance->keyPressCallbackFunc(key, scancode, action, mods);
+		}
+	}
+}
+
+void LGL::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+	LGL* instance = CheckAndGetInstanceByContext(window);
+
+	if (instance)
 	{
-		instance->keyPressCallbackFunc(key, scancode, action, mods);
+		instance->redrawRequested = true;
+		instance->inputState->OnKey(button, action);
 	}
 }
 
@@ -1420,6 +2884,72 @@ void LGL::SetAssetOnOpenGLFailure(bool value)
 	std::cout << "AssertOnFailure has been set to " << value << '\n';
 }
 
+void LGL::SetGLErrorCheckMode(GLErrorCheckMode mode, size_t sampleFrameInterval)
+{
+	errorCheckInterval = std::max<size_t>(sampleFrameInterval, 1);
+	framesSinceErrorCheck = 0;
+
+	// Applied once GLAD is initialized
+	if (!window)
+	{
+		errorCheckMode = mode;
+		return;
+	}
+
+	ContextLock
+
+	// There is no driver to report errors
+	if (GLExecutor::IsNullBackend())
+	{
+		mode = GLErrorCheckMode::Off;
+	}
+
+	if (mode == GLErrorCheckMode::DebugOutput)
+	{
+		// Synchronous output in debug builds, so assertions point at the failed call
+#ifdef _DEBUG
+		constexpr bool synchronous = true;
+#else
+		constexpr bool synchronous = false;
+#endif
+
+		if (!debugOutput->Enable(reinterpret_cast<void* (*)(const char*)>(glfwGetProcAddress), synchronous))
+		{
+			std::cout << "Debug output is not supported, falling back to sampled error checks\n";
+			mode = GLErrorCheckMode::Sampled;
+		}
+	}
+
+	if (mode != GLErrorCheckMode::DebugOutput)
+	{
+		debugOutput->Disable();
+	}
+
+	GLExecutor::SetCheckEveryCall(mode == GLErrorCheckMode::PerCall);
+	errorCheckMode = mode;
+
+	std::cout << "GL error check mode has been set to " << static_cast<int>(mode) << '\n';
+}
+
+void LGL::SetGLDebugSeverityFilter(GLDebugSeverity minSeverity)
+{
+	debugOutput->SetMinSeverity(static_cast<LGLDebugOutput::Severity>(minSeverity));
+
+	std::cout << "GL debug severity filter has been set to " << static_cast<int>(minSeverity) << '\n';
+}
+
+bool LGL::CheckGLErrors()
+{
+	ContextLock
+
+	return GLExecutor::DrainErrors("on demand");
+}
+
+size_t LGL::GetGLErrorCount()
+{
+	return GLExecutor::GetErrorCount();
+}
+
 #define UniformAdapterSection
 
 #define ShaderCallTypeAndVector(type, glFunc)                                                                         \
@@ -16,6 +16,10 @@
 #include <unordered_map>
 #include <functional>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <cstdint>
 #include <unordered_set>
 
 #include "LGLStructs.h"
@@ -23,7 +27,19 @@
 #define CALLBACK static void
 
 struct GLFWwindow;
+template<typename Context> class ContextHolder;
 class LGLUniformHasher;
+class LGLDynamicResolution;
+class LGLTextureUploader;
+class LGLTextureStreamer;
+class LGLTextureRegistry;
+class LGLDebugOutput;
+class LGLOffscreenTarget;
+class LGLFrameCapture;
+class LGLFramePacer;
+class LGLCommandQueue;
+class LGLUploadContext;
+class LGLInputState;
 
 /*
 	Lambda (Open) GL
@@ -49,10 +65,16 @@ private:
 	class InternalModelInfo;
 	using InternalModelMap = std::map<std::string, InternalModelInfo>;
 
+	// CPU side of texture configuration done before the context is taken, defined with LGL internals
+	struct PreparedTexture;
+	using PreparedTextures = std::map<std::string, PreparedTexture>; // By texture name
+
 	// Structs for internal use
 	struct VAOInfo
 	{
 		VAO vboId;
+		VBO vbo;
+		EBO ebo;
 		size_t pointAmount;
 		bool useIndices;
 		LGLStructs::MeshInfo* meshInfo;
@@ -60,6 +82,8 @@ private:
 		VAOInfo()
 		{
 			vboId = 0;
+			vbo = 0;
+			ebo = 0;
 			pointAmount = 0;
 			useIndices = false;
 			meshInfo = nullptr;
@@ -102,6 +126,18 @@ private:
 	public:
 		std::vector<VAOInfo> VAOs;
 		std::map<std::string, TextureID> textureIDs;
+		struct SharedTextureRef
+		{
+			size_t key; // Registry key
+			const LGLStructs::Texture* texture; // Texture of this model registered under the key
+		};
+
+		std::map<std::string, SharedTextureRef> sharedTextures;
+		bool resident = true; // GPU resources of evicted models are recreated once they are rendered again
+		bool restorePending = false; // Meshes are being recreated by render commands, the model is not rendered yet
+		std::map<std::string, size_t> evictedTextureKeys; // Registry keys kept for the restore, not hashed again
+		size_t residentBytes = 0;
+		size_t bufferGeneration = 0; // Uploads queued for other generations of buffers are dropped
 
 		bool IsSmartPtrUsed();
 
@@ -134,6 +170,55 @@ public:
 		GreaterOrEqual
 	};
 
+	// Off - no error checks
+	// PerCall - glGetError after every GL call, precise but serializes the driver
+	// Sampled - error flags are collected with glGetError once every N frames
+	// DebugOutput - driver reports errors through KHR_debug callback, falls back to Sampled if unsupported
+	enum class GLErrorCheckMode
+	{
+		Off,
+		PerCall,
+		Sampled,
+		DebugOutput
+	};
+
+	// Ordered from the least severe
+	enum class GLDebugSeverity
+	{
+		Notification,
+		Low,
+		Medium,
+		High
+	};
+
+	// PNG - file per frame; Raw - RGBA frames, top row first, appended to a single file or pipe
+	enum class CaptureFormat
+	{
+		PNG,
+		Raw
+	};
+
+	// GL calls the null backend would have issued since the last reset
+	struct NullBackendStats
+	{
+		size_t drawCalls;
+		size_t uniformUploads;
+		size_t binds;
+		size_t totalCalls;
+	};
+
+	// Lock of the context of the instance, times in milliseconds. Nested locks of the owning thread are reentries
+	struct ContextLockStats
+	{
+		uint64_t acquisitions;
+		uint64_t contendedAcquisitions;
+		uint64_t reentries;
+		double totalWaitMs;
+		double maxWaitMs;
+		double totalHoldMs;
+		double maxHoldMs;
+	};
+
 	// Public functions
 	LGL_API LGL();
 	LGL_API ~LGL();
@@ -148,9 +233,71 @@ public:
 	LGL_API void RunRenderingCycle(std::function<void()> additionalSteps = nullptr);
 	LGL_API void StopRenderingCycle();
 	LGL_API void PauseRendering(bool value = true);
+
+	// Frames are only rendered after RequestRedraw, input, a window change or a model/text change.
+	// Otherwise the render thread sleeps until one of those, waking every 'idleTickSeconds' 
+	// to run the additional steps, which can request a redraw as well
+	LGL_API void EnableOnDemandRendering(bool value = true, float idleTickSeconds = 0.1f);
+	// Any thread, wakes the render thread if it sleeps
+	LGL_API void RequestRedraw();
+	// Iterations of the rendering cycle which skipped rendering, in on demand mode
+	LGL_API size_t GetSkippedFrameCount();
+
+	// Queues work touching GL objects for the render thread instead of pausing rendering for it.
+	// Queued commands are executed before the next frames, for up to the per frame budget, but at least one per frame.
+	// Called from the render thread or without a running rendering cycle, the command is executed right away
+	LGL_API std::future<void> ExecuteOnRenderThread(std::function<void()> command);
+	LGL_API void SetRenderCommandBudget(float msPerFrame);
+	LGL_API size_t GetPendingRenderCommandAmount();
 	LGL_API glm::vec3& GetBackgroundColorVectorAddr();
 	LGL_API void EnableVSync(bool value = true);
 
+	// Amount of frames (1 to 3) the CPU can prepare before the GPU finishes the oldest of them, 2 by default.
+	// More frames overlap CPU and GPU work better at the cost of input latency
+	LGL_API void SetFramesInFlight(size_t amount);
+	// Slot (0 to frames in flight - 1) of the frame being prepared, for per frame resources rewritten every frame.
+	// The slot is free for rewriting within the render pass (behaviours), not in commands or additional steps before it
+	LGL_API size_t GetFrameSlot();
+	// Milliseconds the render thread waited for the GPU at the start of the last frame, and on average
+	LGL_API float GetLastFenceWaitTime();
+	LGL_API float GetAverageFenceWaitTime();
+
+	// Renders the scene at 'minScale' to 'maxScale' of the window resolution,
+	// picking the scale by GPU frame time against 'targetFrameTimeMs'. Text is always rendered natively
+	LGL_API void EnableDynamicResolution(
+		bool value = true, 
+		float targetFrameTimeMs = 16.6f, 
+		float minScale = 0.5f, 
+		float maxScale = 1.0f
+	);
+	LGL_API float GetDynamicResolutionScale();
+
+	// Frames are rendered to an offscreen framebuffer of a window which is never shown, so real rendering
+	// can run where nothing is displayed (e.g. Xvfb with Mesa llvmpipe). The cycle stops after 'frameCount' frames 
+	// (0 - unlimited), render delta is reported as 'fixedDeltaTime' seconds if it is above 0. 
+	// If 'readbackLastFrame' is set, the last frame is kept for GetLastFrame. Must be called before CreateWindow
+	LGL_API void EnableHeadlessMode(
+		bool value = true, 
+		size_t frameCount = 0, 
+		float fixedDeltaTime = 0.0f, 
+		bool readbackLastFrame = false
+	);
+	LGL_API bool IsHeadless();
+	LGL_API size_t GetRenderedFrameCount();
+	// RGBA, rows from the bottom. Available once the rendering cycle of a headless instance finishes
+	LGL_API bool GetLastFrame(std::vector<unsigned char>& pixels, int& width, int& height);
+	// Binary PPM, so frames can be compared with golden images without an image library
+	LGL_API bool SaveLastFrame(const std::string& path);
+
+	// Frames are read back asynchronously and written by a background thread, the render loop never waits for them.
+	// PNG frames are named 'path' followed by the frame number, Raw frames are appended to 'path'.
+	// 'frameAmount' frames are captured, 0 - until StopFrameCapture. Frames which can not be kept up with are dropped
+	LGL_API void StartFrameCapture(const std::string& path, CaptureFormat format = CaptureFormat::PNG, size_t frameAmount = 0);
+	LGL_API void StopFrameCapture();
+	LGL_API bool IsCapturingFrames();
+	LGL_API size_t GetCapturedFrameCount();
+	LGL_API size_t GetDroppedCaptureFrameCount();
+
 	// Creates a VAO, VBO and (if indices are given) EBO
 	// Must accept amount of steps for
 	// You can pass a lambda to describe general behaviour for your shape
@@ -168,20 +315,69 @@ public:
 	LGL_API void CreateText(const std::string& textLabel, LGLStructs::TextInfo& text);
 
 	LGL_API void DeleteModel(const std::string& modelName);
+
+	// Queued versions of the above, see ExecuteOnRenderThread. Meshes of the model are created one per command,
+	// so a large model is spread over several frames. Model data must stay valid until the future is ready
+	LGL_API std::future<void> CreateModelAsync(const std::string& modelName, std::weak_ptr<LGLStructs::ModelInfo> model);
+	LGL_API std::future<void> DeleteModelAsync(const std::string& modelName);
+
+	// Releases VAOs, buffers and textures of the model, CPU side data is kept and uploaded again over
+	// the following frames once the model should be rendered. The model is not drawn until it is back
+	LGL_API void EvictModel(const std::string& modelName);
+	LGL_API bool IsModelResident(const std::string& modelName);
+	// Approximate VRAM taken by vertex data and textures of resident models
+	LGL_API size_t GetResidentModelBytes();
 	LGL_API void DeleteText(const std::string& textLabel);
 #endif
 	LGL_API bool ConfigureTexture(const std::string& modelName, const LGLStructs::Texture& texture);
 
+	// Textures are prepared on a worker thread and uploaded by the render loop within the per frame budget
+	// A 1x1 white placeholder is bound in place of a texture until its upload is finished
+	LGL_API void EnableAsyncTextureUpload(
+		bool value = true, 
+		size_t bytesPerFrame = 4 * 1024 * 1024, 
+		float msPerFrame = 2.0f
+	);
+
+	// Textures are uploaded with their low resolution mips only, finer mips are streamed in by screen size
+	// of the model reported with SetModelScreenSize. Top mips of textures not sampled recently are evicted
+	// to keep the streamed textures under 'vramBudgetBytes'. Enables async texture upload
+	LGL_API void EnableTextureStreaming(bool value = true, size_t vramBudgetBytes = 256 * 1024 * 1024);
+	// Largest size in pixels the model covers on screen, 0 if it is not visible
+	LGL_API void SetModelScreenSize(const std::string& modelName, float screenSize);
+
+	// Vertex data and textures are uploaded by a dedicated thread with a loader context shared with the main one.
+	// Meshes and textures become visible to rendering once their upload is finished on the GPU, a placeholder
+	// is bound in place of a texture until then. Textures are left to async upload if it is enabled.
+	// Must be called from the thread which created the window, the loader is stopped with the rendering cycle
+	LGL_API bool EnableSharedContextUpload(bool value = true);
+	LGL_API size_t GetPendingUploadAmount();
+
+	// Every instance locks only its own context, threads already holding it pass without touching the lock
+	LGL_API ContextLockStats GetContextLockStats();
+	LGL_API void ResetContextLockStats();
+
 	LGL_API static void InitOpenGL(int major, int minor);
 
 	LGL_API static void TerminateOpenGL();
 
+	// Used instead of InitOpenGL. No window or context is created and GL functions are only counted, not called,
+	// so CPU side cost of rendering can be measured without a GPU. Object names are faked, status queries succeed
+	LGL_API static void InitNullBackend();
+	LGL_API static bool IsNullBackend();
+	LGL_API NullBackendStats GetNullBackendStats();
+	// Amount of calls of every GL function since the last reset
+	LGL_API std::map<std::string, size_t> GetNullBackendCallCounters();
+	LGL_API void ResetNullBackendStats();
+
 	LGL_API void SetDepthTest(DepthTestMode depthTestMode);
 
 	LGL_API int GetMaxAmountOfVertexAttr();
 
 	LGL_API void CaptureMouse(bool value);
 
+	// 'pressedFunc' is called on the press of the key, and every frame it stays held if 'holdable',
+	// 'releasedFunc' on its release. Mouse buttons are accepted as keys
 	LGL_API void SetInteractable(
 		int keyID, 
 		bool holdable,
@@ -195,8 +391,18 @@ public:
 
 	LGL_API void SetAssetOnOpenGLFailure(bool value);
 
+	// DebugOutput is the default in debug builds, Sampled every 60 frames in release
+	LGL_API void SetGLErrorCheckMode(GLErrorCheckMode mode, size_t sampleFrameInterval = 60);
+	// Debug output messages less severe than 'minSeverity' are ignored
+	LGL_API void SetGLDebugSeverityFilter(GLDebugSeverity minSeverity);
+	// Collects errors set since the last check right away, returns true if there were any
+	LGL_API bool CheckGLErrors();
+	// Amount of errors reported by any of the modes since the start
+	LGL_API size_t GetGLErrorCount();
+
 	LGL_API void SetShaderFolder(const std::string& path);
 	LGL_API void RecompileShader(const std::string& shaderName);
+	LGL_API std::future<void> RecompileShaderAsync(const std::string& shaderName);
 
 	LGL_API void ResetLGL();
 
@@ -218,6 +424,23 @@ public:
 
 private:
 	bool InitGLAD();
+
+	static void CreateMeshBuffers(
+		const std::vector<LGLStructs::Vertex>& vert, 
+		const std::vector<unsigned int>& indices, 
+		bool isDynamic, 
+		VBO& newVBO, 
+		EBO& newEBO
+	);
+	void CreateMeshVAO(InternalModelInfo& newVAOInfo, LGLStructs::MeshInfo& meshInfo, VBO newVBO, EBO newEBO);
+	void QueueMeshUpload(const std::string& modelName, LGLStructs::MeshInfo& meshInfo);
+	void CreateMeshImpl(
+		const std::string& modelName, 
+		LGLStructs::MeshInfo& meshInfo, 
+		const PreparedTextures* preparedTextures, 
+		bool deferTextureUpload = false
+	);
+	void PrepareTextures(LGLStructs::MeshInfo* meshes, size_t meshAmount, PreparedTextures& preparedTextures);
 	void InitCallbacks();
 
 	void DeleteGLObjects();
@@ -243,7 +466,29 @@ private:
 
 	void ProduceTextTexAtlas(const LGLStructs::GlyphInfo& glyphText, AtlasInfo& atlasInfo);
 	void CalcAtlasDimensions(const LGLStructs::GlyphInfo& glyphInfo, AtlasInfo& atlasInfo);
-	bool ConfigureTextureImpl(TextureID& newTextureID, const LGLStructs::Texture& texture);
+	// Deferred textures are uploaded as with async upload, with the placeholder bound meanwhile
+	bool ConfigureTexture(
+		const std::string& modelName, 
+		const LGLStructs::Texture& texture, 
+		const PreparedTexture* preparedTexture, 
+		bool deferUpload = false
+	);
+	bool ConfigureTextureImpl(
+		TextureID& newTextureID, 
+		const LGLStructs::Texture& texture, 
+		bool loaderThread = false, 
+		const PreparedTexture* preparedTexture = nullptr
+	);
+	void QueueTextureUpload(const std::string& modelName, const LGLStructs::Texture& texture, size_t textureKey, bool compress);
+	bool ReplacePlaceholderTexture(size_t textureKey, TextureID textureID);
+	static unsigned int GetTextureFormat(int channelAmount);
+	bool IsTextureCompressible(const LGLStructs::Texture& texture);
+	void SetTextureParams(const LGLStructs::Texture::TextureParams& params, int maxLevel);
+	void CreatePlaceholderTexture();
+	void ProcessTextureUploads();
+	void ReleaseModelTextures(InternalModelInfo& modelInfo);
+	void ReleaseModelBuffers(InternalModelInfo& modelInfo);
+	void RestoreModel(const std::string& modelName, InternalModelInfo& modelInfo);
 
 	// If shader file names can be identical to shader program name, general load and compile can be used
 	bool LoadAndCompileShader(const std::string& name);
@@ -263,16 +508,22 @@ private:
 	CALLBACK KeyPressCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 	std::function<void(int, int, int, int)> keyPressCallbackFunc;
 
+	CALLBACK MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+
 	std::function<void(float)> renderTimeCallbackFunc;
 
 	static LGL* CheckAndGetInstanceByContext(GLFWwindow* window);
 	static std::map<GLFWwindow*, LGL*> contextToInstance;
 
+	// GLFW has no getter for window hints, so the last visibility set by LGL is kept to restore it
+	static int windowVisibleHint;
+
 	void ProcessInput();
 	void Render();
 	void RenderText();
 	void PauseRenderingImpl(bool value);
 	void PauseRenderingInternal(bool value = true);
+	void WaitForRedraw();
 
 	int windowWidth;
 	int windowHeight;
@@ -280,13 +531,24 @@ private:
 	float renderDeltaTime;
 
 	bool useVSync; // Passed value is not bool, but will do for on/off switch
+	bool textureCompressionSupported;
 	bool pauseRendering;
 	bool externalRenderPauseActive;
 	bool stopRendering;
 	std::mutex pauserMux;
 	std::condition_variable pauser;
 
+	std::atomic<bool> onDemandRendering;
+	std::atomic<bool> redrawRequested;
+	float onDemandIdleTick;
+	size_t skippedFrameCount;
+	std::thread::id renderThreadID;
+	std::atomic<bool> renderCycleRunning;
+	std::mutex redrawMux;
+	std::condition_variable redrawCondVar;
+
 	GLFWwindow* window;
+	std::unique_ptr<ContextHolder<GLFWwindow>> windowContext;
 
 	glm::vec3 background;
 
@@ -309,6 +571,8 @@ private:
 	std::map<ShaderName, std::pair<ShaderProgramID, std::map<ShaderType, ShaderInfo>>> shaderInfoCollection;
 
 	std::map<size_t, InteractableInfo> interactCollection;
+	std::vector<size_t> heldInteractables;
+	std::unique_ptr<LGLInputState> inputState;
 
 	bool batchUniformVals;
 	bool hashUniformVals;
@@ -316,6 +580,43 @@ private:
 	std::unordered_set<size_t> uniformLocationTracker;
 	std::unordered_map<ShaderProgramID, std::unordered_map<std::string, int>> uniformLocationCache;
 	std::unique_ptr<LGLUniformHasher> uniformHasher;
+
+	std::unique_ptr<LGLDynamicResolution> dynamicResolution;
+
+	bool headless;
+	size_t headlessFrameCount;
+	float headlessFixedDeltaTime;
+	bool headlessReadback;
+	size_t renderedFrameCount;
+	std::vector<unsigned char> lastFramePixels;
+	int lastFrameWidth;
+	int lastFrameHeight;
+	std::unique_ptr<LGLOffscreenTarget> offscreenTarget;
+
+	std::unique_ptr<LGLFrameCapture> frameCapture;
+
+	std::unique_ptr<LGLFramePacer> framePacer;
+
+	float renderCommandMsPerFrame;
+	std::unique_ptr<LGLCommandQueue> commandQueue;
+
+	size_t lastBufferGeneration;
+	std::unique_ptr<LGLUploadContext> uploadContext;
+
+	GLErrorCheckMode errorCheckMode;
+	size_t errorCheckInterval;
+	size_t framesSinceErrorCheck;
+	std::unique_ptr<LGLDebugOutput> debugOutput;
+
+	bool asyncTextureUpload;
+	size_t textureUploadBytesPerFrame;
+	float textureUploadMsPerFrame;
+	TextureID placeholderTexture;
+	std::unique_ptr<LGLTextureUploader> textureUploader;
+	std::unique_ptr<LGLTextureRegistry> textureRegistry;
+
+	bool textureStreaming;
+	std::unique_ptr<LGLTextureStreamer> textureStreamer;
 };
 
 #undef CALLBACK
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+
+/*
+	Intrusive multi producer, single consumer queue of commands for the render thread.
+	Any thread pushes a command and gets a future of it, pushing never takes a lock.
+	Commands are executed in the order they were pushed, by a single thread at a time
+*/
+class LGLCommandQueue
+{
+	struct Node
+	{
+		std::atomic<Node*> next = nullptr;
+		std::packaged_task<void()> task;
+	};
+
+	// Producers append after 'head', the consumer takes from 'tail'. Stub keeps the list never empty
+	std::atomic<Node*> head;
+	Node* tail;
+	Node stub;
+
+	std::atomic<size_t> pendingAmount = 0;
+
+	void PushNode(Node* node)
+	{
+		node->next.store(nullptr, std::memory_order_relaxed);
+		Node* prev = head.exchange(node, std::memory_order_acq_rel);
+		prev->next.store(node, std::memory_order_release);
+	}
+
+	// Nullptr if the queue is empty or the last pushed node is not linked yet
+	Node* PopNode()
+	{
+		Node* current = tail;
+		Node* next = current->next.load(std::memory_order_acquire);
+
+		if (current == &stub)
+		{
+			if (!next)
+			{
+				return nullptr;
+			}
+
+			tail = next;
+			current = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+
+		if (next)
+		{
+			tail = next;
+			return current;
+		}
+
+		if (current != head.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+
+		// Last node can be taken only with something after it, so the stub goes back in
+		PushNode(&stub);
+		next = current->next.load(std::memory_order_acquire);
+
+		if (next)
+		{
+			tail = next;
+			return current;
+		}
+
+		return nullptr;
+	}
+
+public:
+	LGLCommandQueue()
+		: head(&stub), tail(&stub)
+	{}
+
+	// Futures of commands never executed report a broken promise
+	~LGLCommandQueue()
+	{
+		while (Node* node = PopNode())
+		{
+			delete node;
+		}
+	}
+
+	LGLCommandQueue(const LGLCommandQueue&) = delete;
+	LGLCommandQueue& operator=(const LGLCommandQueue&) = delete;
+
+	// Any thread. Exceptions thrown by the command are passed to the future
+	std::future<void> Push(std::function<void()> command)
+	{
+		Node* node = new Node;
+		node->task = std::packaged_task<void()>(std::move(command));
+		std::future<void> result = node->task.get_future();
+
+		++pendingAmount;
+		PushNode(node);
+
+		return result;
+	}
+
+	// Any thread
+	size_t GetPendingAmount()
+	{
+		return pendingAmount;
+	}
+
+	// Consumer only. Executes commands until the queue is empty or 'budgetMs' is spent,
+	// at least one command is executed. Negative budget is unlimited. Returns amount of executed commands
+	size_t Execute(float budgetMs = -1.0f)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		size_t executedAmount = 0;
+
+		while (Node* node = PopNode())
+		{
+			node->task();
+			delete node;
+
+			--pendingAmount;
+			++executedAmount;
+
+			if (budgetMs >= 0.0f &&
+				std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= budgetMs)
+			{
+				break;
+			}
+		}
+
+		return executedAmount;
+	}
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "GLExecutor.h"
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+// KHR_debug is not a part of 3.3 core, defined here since GLAD was generated without the extension
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#endif
+
+#ifndef GL_DEBUG_OUTPUT_SYNCHRONOUS
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#endif
+
+#ifndef GL_DEBUG_TYPE_ERROR
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#endif
+
+#ifndef GL_DEBUG_SEVERITY_HIGH
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#endif
+
+#ifndef GL_DEBUG_SEVERITY_NOTIFICATION
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
+/*
+	Driver side error reporting through KHR_debug (or ARB_debug_output) callback.
+	Messages are filtered by severity and each distinct message is printed once,
+	repeats are only counted and reported at powers of 10
+*/
+class LGLDebugOutput
+{
+public:
+	// Ordered from the least severe
+	enum class Severity
+	{
+		Notification,
+		Low,
+		Medium,
+		High
+	};
+
+private:
+	using ProcLoader = void* (*)(const char*);
+	using DebugMessageCallbackProc = void (APIENTRY*)(GLDEBUGPROC callback, const void* userParam);
+
+	std::atomic<Severity> minSeverity = Severity::Low;
+	bool enabled = false;
+	bool khrDebug = false; // GL_DEBUG_OUTPUT exists only with KHR_debug, ARB output is on while a callback is set
+	DebugMessageCallbackProc debugMessageCallback = nullptr;
+
+	std::mutex messageMux;
+	std::unordered_map<uint64_t, size_t> messageCounter;
+
+	// Ids are only unique within a source and type. Enums of both fit 16 bits
+	static uint64_t GetMessageKey(GLenum source, GLenum type, GLuint id)
+	{
+		return (static_cast<uint64_t>(source & 0xFFFF) << 48) | (static_cast<uint64_t>(type & 0xFFFF) << 32) | id;
+	}
+
+	static Severity ConvertSeverity(GLenum severity)
+	{
+		switch (severity)
+		{
+		case GL_DEBUG_SEVERITY_HIGH:
+			return Severity::High;
+		case GL_DEBUG_SEVERITY_MEDIUM:
+			return Severity::Medium;
+		case GL_DEBUG_SEVERITY_LOW:
+			return Severity::Low;
+		default:
+			return Severity::Notification;
+		}
+	}
+
+	static void APIENTRY DebugCallback(
+		GLenum source,
+		GLenum type,
+		GLuint id,
+		GLenum severity,
+		GLsizei length,
+		const GLchar* message,
+		const void* userParam
+	)
+	{
+		LGLDebugOutput& self = *static_cast<LGLDebugOutput*>(const_cast<void*>(userParam));
+		const Severity convertedSeverity = ConvertSeverity(severity);
+
+		if (convertedSeverity < self.minSeverity)
+		{
+			return;
+		}
+
+		// Callback can be called from driver threads unless output is synchronous
+		std::lock_guard<std::mutex> lock(self.messageMux);
+
+		size_t& counter = ++self.messageCounter[GetMessageKey(source, type, id)];
+
+		if (type == GL_DEBUG_TYPE_ERROR)
+		{
+			GLExecutor::CountError();
+		}
+
+		if (counter == 1)
+		{
+			std::cerr << "OpenGL " << (type == GL_DEBUG_TYPE_ERROR ? "ERROR" : "message") << " (" << id << "): " << message << '\n';
+			assert(!(GLExecutor::GetAssertOnFailure() && type == GL_DEBUG_TYPE_ERROR) && "OpenGL ERROR: check log");
+		}
+		else if (IsPowerOf10(counter))
+		{
+			std::cerr << "OpenGL message (" << id << ") repeated " << counter << " times\n";
+		}
+	}
+
+	static bool IsPowerOf10(size_t value)
+	{
+		while (value >= 10 && value % 10 == 0)
+		{
+			value /= 10;
+		}
+
+		return value == 1;
+	}
+
+public:
+	// Context must be set. Returns false if neither of the extensions is supported
+	bool Enable(ProcLoader loader, bool synchronous)
+	{
+		if (enabled)
+		{
+			return true;
+		}
+
+		debugMessageCallback = reinterpret_cast<DebugMessageCallbackProc>(loader("glDebugMessageCallback"));
+		khrDebug = debugMessageCallback != nullptr;
+
+		if (!debugMessageCallback)
+		{
+			debugMessageCallback = reinterpret_cast<DebugMessageCallbackProc>(loader("glDebugMessageCallbackARB"));
+		}
+
+		if (!debugMessageCallback)
+		{
+			return false;
+		}
+
+		if (khrDebug)
+		{
+			GLSafeExecute(glEnable, GL_DEBUG_OUTPUT);
+		}
+
+		if (synchronous)
+		{
+			GLSafeExecute(glEnable, GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		}
+
+		debugMessageCallback(DebugCallback, this);
+		enabled = true;
+
+		return true;
+	}
+
+	void Disable()
+	{
+		if (enabled)
+		{
+			if (khrDebug)
+			{
+				GLSafeExecute(glDisable, GL_DEBUG_OUTPUT);
+			}
+
+			GLSafeExecute(glDisable, GL_DEBUG_OUTPUT_SYNCHRONOUS);
+			debugMessageCallback(nullptr, nullptr);
+			enabled = false;
+		}
+	}
+
+	bool IsEnabled()
+	{
+		return enabled;
+	}
+
+	void SetMinSeverity(Severity severity)
+	{
+		minSeverity = severity;
+	}
+};
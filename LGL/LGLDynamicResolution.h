@@ -0,0 +1,281 @@
+#pragma once
+
+#include "GLExecutor.h"
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+
+/*
+	Renders the 3D scene into an offscreen framebuffer at a fraction of the window size
+	and upscales it to the default framebuffer. Scale is driven by GPU time of the scene pass,
+	measured with timer queries, against the target frame time
+*/
+class LGLDynamicResolution
+{
+private:
+	using FBO = unsigned int;
+	using RBO = unsigned int;
+	using TextureID = unsigned int;
+	using QueryID = unsigned int;
+
+	// Several queries in flight, so reading the result never stalls the pipeline
+	constexpr static size_t QueryAmount = 4;
+	// Render time is only reevaluated after this amount of measured frames
+	constexpr static size_t FramesPerAdjustment = 8;
+	// Scale is increased only when GPU time is below this part of the target
+	constexpr static float IncreaseThreshold = 0.8f;
+	constexpr static float MaxScaleStep = 0.1f;
+	constexpr static float MinScaleStep = 0.02f;
+
+	struct TimerQuery
+	{
+		QueryID id = 0;
+		bool pending = false;
+	};
+
+	std::atomic<bool> enabled = false;
+	std::atomic<float> targetFrameTime = 16.6f;
+	std::atomic<float> minScale = 0.5f;
+	std::atomic<float> maxScale = 1.0f;
+	std::atomic<float> currentScale = 1.0f;
+
+	bool resourcesCreated = false;
+	bool frameActive = false;
+	FBO fbo = 0;
+	TextureID colorTex = 0;
+	RBO depthRBO = 0;
+	int allocatedWidth = 0;
+	int allocatedHeight = 0;
+	int scaledWidth = 0;
+	int scaledHeight = 0;
+
+	std::array<TimerQuery, QueryAmount> queries;
+	size_t currentQuery = 0;
+	float accumulatedGPUTime = 0.0f;
+	size_t measuredFrames = 0;
+
+	void CreateResources(int width, int height)
+	{
+		GLSafeExecute(glGenFramebuffers, 1, &fbo);
+		GLSafeExecute(glGenTextures, 1, &colorTex);
+		GLSafeExecute(glGenRenderbuffers, 1, &depthRBO);
+
+		for (auto& query : queries)
+		{
+			GLSafeExecute(glGenQueries, 1, &query.id);
+			query.pending = false;
+		}
+
+		resourcesCreated = true;
+
+		AllocateStorage(width, height);
+	}
+
+	// Storage is allocated for the full window size, scaled frames only use the lower left part of it
+	void AllocateStorage(int width, int height)
+	{
+		GLSafeExecute(glBindTexture, GL_TEXTURE_2D, colorTex);
+		GLSafeExecute(glTexImage2D, GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		GLSafeExecute(glBindTexture, GL_TEXTURE_2D, 0);
+
+		GLSafeExecute(glBindRenderbuffer, GL_RENDERBUFFER, depthRBO);
+		GLSafeExecute(glRenderbufferStorage, GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+		GLSafeExecute(glBindRenderbuffer, GL_RENDERBUFFER, 0);
+
+		GLSafeExecute(glBindFramebuffer, GL_FRAMEBUFFER, fbo);
+		GLSafeExecute(glFramebufferTexture2D, GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+		GLSafeExecute(glFramebufferRenderbuffer, GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+		if (GLSafeExecuteRet(glCheckFramebufferStatus, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cerr << "Dynamic resolution framebuffer is incomplete, disabling\n";
+			enabled = false;
+		}
+
+		GLSafeExecute(glBindFramebuffer, GL_FRAMEBUFFER, 0);
+
+		allocatedWidth = width;
+		allocatedHeight = height;
+	}
+
+	void CollectQueryResults()
+	{
+		for (auto& query : queries)
+		{
+			if (!query.pending) continue;
+
+			int available = 0;
+			GLSafeExecute(glGetQueryObjectiv, query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+
+			if (available)
+			{
+				GLuint64 elapsedNs = 0;
+				GLSafeExecute(glGetQueryObjectui64v, query.id, GL_QUERY_RESULT, &elapsedNs);
+				query.pending = false;
+
+				accumulatedGPUTime += static_cast<float>(elapsedNs) / 1000000.0f;
+				++measuredFrames;
+			}
+		}
+
+		if (measuredFrames >= FramesPerAdjustment)
+		{
+			AdjustScale(accumulatedGPUTime / measuredFrames);
+
+			accumulatedGPUTime = 0.0f;
+			measuredFrames = 0;
+		}
+	}
+
+	// Pixel cost grows with the square of the scale, so the correction is square rooted
+	void AdjustScale(float averageGPUTime)
+	{
+		const float target = targetFrameTime;
+		const float scale = currentScale;
+
+		if (averageGPUTime <= 0.0f || (averageGPUTime <= target && averageGPUTime >= target * IncreaseThreshold))
+		{
+			return;
+		}
+
+		float step = scale * std::sqrt(target * IncreaseThreshold / averageGPUTime) - scale;
+		step = std::clamp(std::abs(step), MinScaleStep, MaxScaleStep) * (step < 0.0f ? -1.0f : 1.0f);
+
+		currentScale = std::clamp(scale + step, minScale.load(), maxScale.load());
+	}
+
+public:
+	void Enable(bool value, float targetFrameTimeMs, float minScaleValue, float maxScaleValue)
+	{
+		minScale = std::clamp(std::min(minScaleValue, maxScaleValue), 0.1f, 1.0f);
+		maxScale = std::clamp(std::max(minScaleValue, maxScaleValue), 0.1f, 1.0f);
+		targetFrameTime = targetFrameTimeMs > 0.0f ? targetFrameTimeMs : 16.6f;
+		currentScale = maxScale.load();
+		enabled = value;
+	}
+
+	bool IsEnabled()
+	{
+		return enabled;
+	}
+
+	float GetCurrentScale()
+	{
+		return enabled ? currentScale.load() : 1.0f;
+	}
+
+	// Must be called with context set, before the scene is cleared and drawn
+	// Returns false if scene should be rendered directly to the default framebuffer
+	bool BeginFrame(int windowWidth, int windowHeight)
+	{
+		if (!enabled || windowWidth <= 0 || windowHeight <= 0)
+		{
+			if (resourcesCreated)
+			{
+				Release();
+			}
+
+			return false;
+		}
+
+		if (!resourcesCreated)
+		{
+			CreateResources(windowWidth, windowHeight);
+		}
+		else if (allocatedWidth != windowWidth || allocatedHeight != windowHeight)
+		{
+			AllocateStorage(windowWidth, windowHeight);
+		}
+
+		if (!enabled)
+		{
+			Release();
+			return false;
+		}
+
+		CollectQueryResults();
+
+		const float scale = currentScale;
+		scaledWidth = std::max(1, static_cast<int>(windowWidth * scale));
+		scaledHeight = std::max(1, static_cast<int>(windowHeight * scale));
+
+		GLSafeExecute(glBindFramebuffer, GL_FRAMEBUFFER, fbo);
+		GLSafeExecute(glViewport, 0, 0, scaledWidth, scaledHeight);
+
+		// If all queries are still in flight this frame is not measured
+		TimerQuery& query = queries[currentQuery];
+		if (!query.pending)
+		{
+			GLSafeExecute(glBeginQuery, GL_TIME_ELAPSED, query.id);
+		}
+
+		frameActive = true;
+
+		return true;
+	}
+
+	// Upscales rendered scene to the target framebuffer, anything drawn after is at native resolution
+	void EndFrame(int windowWidth, int windowHeight, FBO targetFBO = 0)
+	{
+		if (!frameActive)
+		{
+			return;
+		}
+
+		frameActive = false;
+
+		TimerQuery& query = queries[currentQuery];
+		if (!query.pending)
+		{
+			GLSafeExecute(glEndQuery, GL_TIME_ELAPSED);
+			query.pending = true;
+			currentQuery = (currentQuery + 1) % QueryAmount;
+		}
+
+		GLSafeExecute(glBindFramebuffer, GL_READ_FRAMEBUFFER, fbo);
+		GLSafeExecute(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, targetFBO);
+		GLSafeExecute(glViewport, 0, 0, windowWidth, windowHeight);
+		GLSafeExecute(glClear, GL_DEPTH_BUFFER_BIT);
+		GLSafeExecute(
+			glBlitFramebuffer,
+			0, 0, scaledWidth, scaledHeight,
+			0, 0, windowWidth, windowHeight,
+			GL_COLOR_BUFFER_BIT, GL_LINEAR
+		);
+		GLSafeExecute(glBindFramebuffer, GL_FRAMEBUFFER, targetFBO);
+	}
+
+	// Must be called with context set
+	void Release()
+	{
+		if (!resourcesCreated)
+		{
+			return;
+		}
+
+		GLSafeExecute(glDeleteFramebuffers, 1, &fbo);
+		GLSafeExecute(glDeleteTextures, 1, &colorTex);
+		GLSafeExecute(glDeleteRenderbuffers, 1, &depthRBO);
+
+		for (auto& query : queries)
+		{
+			GLSafeExecute(glDeleteQueries, 1, &query.id);
+			query = {};
+		}
+
+		fbo = 0;
+		colorTex = 0;
+		depthRBO = 0;
+		allocatedWidth = 0;
+		allocatedHeight = 0;
+		currentQuery = 0;
+		accumulatedGPUTime = 0.0f;
+		measuredFrames = 0;
+		frameActive = false;
+		resourcesCreated = false;
+	}
+};
@@ -0,0 +1,558 @@
+#pragma once
+
+#include "GLExecutor.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+/*
+	Non-blocking frame capture. Frames are read into a ring of pixel pack buffers guarded by fences,
+	buffers are mapped once their fence is signaled, a few frames later. Mapped data is copied and written
+	by a background thread, so the render thread only issues the reads and maps/unmaps the buffers
+*/
+class LGLFrameCapture
+{
+public:
+	enum class Format
+	{
+		PNG,
+		Raw
+	};
+
+	LGLFrameCapture()
+	{
+		writer = std::thread([this]() { WriterLoop(); });
+	}
+
+	~LGLFrameCapture()
+	{
+		{
+			std::lock_guard<std::mutex> lock(queueMux);
+			stopWriter = true;
+		}
+		queueCondVar.notify_all();
+		writer.join();
+	}
+
+	// Any thread. PNG - file per frame, named 'path' followed by the frame number; Raw - RGBA frames, top row first,
+	// appended to 'path', which can be a named pipe of an external encoder. 0 'frameAmount' captures until stopped
+	void Start(const std::string& path, Format format, size_t frameAmount)
+	{
+		auto session = std::make_shared<Session>();
+		session->path = path;
+		session->format = format;
+		session->frameAmount = frameAmount;
+
+		std::lock_guard<std::mutex> lock(sessionMux);
+		pendingSession = std::move(session);
+		active = true;
+	}
+
+	void Stop()
+	{
+		std::lock_guard<std::mutex> lock(sessionMux);
+		pendingSession.reset();
+		active = false;
+	}
+
+	bool IsActive()
+	{
+		return active;
+	}
+
+	// Frames skipped because buffers or the writer could not keep up
+	size_t GetDroppedFrames()
+	{
+		return droppedFrames;
+	}
+
+	size_t GetWrittenFrames()
+	{
+		return writtenFrames;
+	}
+
+	// Render thread only, with context set. Reads the finished frame from 'readFBO'
+	void Process(int width, int height, unsigned int readFBO)
+	{
+		CollectFinished();
+
+		if (!active)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(sessionMux);
+
+			// Could have been stopped since the check
+			if (!active)
+			{
+				return;
+			}
+
+			if (pendingSession)
+			{
+				currentSession = std::move(pendingSession);
+				capturedFrames = 0;
+			}
+		}
+
+		Slot& slot = slots[nextSlot];
+
+		if (slot.fence || slot.mapped || width <= 0 || height <= 0)
+		{
+			++droppedFrames;
+			return;
+		}
+
+		if (!resourcesCreated)
+		{
+			CreateResources();
+		}
+
+		const size_t size = static_cast<size_t>(width) * height * 4;
+
+		GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+		if (slot.allocatedSize != size)
+		{
+			GLSafeExecute(glBufferData, GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+			slot.allocatedSize = size;
+		}
+
+		GLSafeExecute(glBindFramebuffer, GL_READ_FRAMEBUFFER, readFBO);
+		GLSafeExecute(glPixelStorei, GL_PACK_ALIGNMENT, 4);
+		GLSafeExecute(glReadPixels, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, 0);
+
+		slot.fence = GLSafeExecuteRet(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		slot.width = width;
+		slot.height = height;
+		slot.frameIndex = capturedFrames++;
+		slot.session = currentSession;
+
+		nextSlot = (nextSlot + 1) % SlotAmount;
+
+		if (currentSession->frameAmount && capturedFrames >= currentSession->frameAmount)
+		{
+			std::lock_guard<std::mutex> lock(sessionMux);
+
+			if (!pendingSession)
+			{
+				active = false;
+			}
+		}
+	}
+
+	// Render thread only, with context set. Buffers being copied by the writer are waited for
+	void Release()
+	{
+		for (auto& slot : slots)
+		{
+			if (slot.mapped)
+			{
+				std::unique_lock<std::mutex> lock(queueMux);
+				copyCondVar.wait(lock, [&slot]() { return slot.copied.load(); });
+				lock.unlock();
+
+				GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, slot.pbo);
+				GLSafeExecute(glUnmapBuffer, GL_PIXEL_PACK_BUFFER);
+				GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, 0);
+			}
+
+			if (slot.fence)
+			{
+				GLSafeExecute(glDeleteSync, slot.fence);
+			}
+
+			if (slot.pbo)
+			{
+				GLSafeExecute(glDeleteBuffers, 1, &slot.pbo);
+			}
+
+			slot.pbo = 0;
+			slot.allocatedSize = 0;
+			slot.fence = nullptr;
+			slot.mapped = false;
+			slot.copied = false;
+			slot.session.reset();
+		}
+
+		nextSlot = 0;
+		resourcesCreated = false;
+	}
+
+private:
+	// Enough for the GPU to finish the read before the buffer is needed again at 60 fps
+	constexpr static size_t SlotAmount = 3;
+	// Copied frames waiting to be encoded, newer frames are dropped while the queue is full
+	constexpr static size_t MaxQueuedFrames = 8;
+
+	struct Session
+	{
+		std::string path;
+		Format format;
+		size_t frameAmount;
+	};
+
+	struct Slot
+	{
+		unsigned int pbo = 0;
+		size_t allocatedSize = 0;
+		GLsync fence = nullptr;
+		bool mapped = false;
+		std::atomic<bool> copied = false;
+		int width = 0;
+		int height = 0;
+		size_t frameIndex = 0;
+		std::shared_ptr<const Session> session;
+	};
+
+	struct WriteJob
+	{
+		Slot* slot = nullptr;
+		const unsigned char* mappedData = nullptr;
+		std::vector<unsigned char> pixels;
+		int width;
+		int height;
+		size_t frameIndex;
+		std::shared_ptr<const Session> session;
+	};
+
+	void CreateResources()
+	{
+		for (auto& slot : slots)
+		{
+			GLSafeExecute(glGenBuffers, 1, &slot.pbo);
+		}
+
+		resourcesCreated = true;
+	}
+
+	// Slots are checked from the oldest, so frames reach the writer in order
+	void CollectFinished()
+	{
+		for (size_t i = 0; i < SlotAmount; ++i)
+		{
+			Slot& slot = slots[(nextSlot + i) % SlotAmount];
+
+			if (slot.mapped && slot.copied)
+			{
+				GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, slot.pbo);
+				GLSafeExecute(glUnmapBuffer, GL_PIXEL_PACK_BUFFER);
+				GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, 0);
+
+				slot.mapped = false;
+				slot.copied = false;
+				slot.session.reset();
+			}
+		}
+
+		for (size_t i = 0; i < SlotAmount; ++i)
+		{
+			Slot& slot = slots[(nextSlot + i) % SlotAmount];
+
+			if (!slot.fence)
+			{
+				continue;
+			}
+
+			const GLenum status = GLSafeExecuteRet(glClientWaitSync, slot.fence, 0, 0);
+
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			{
+				break;
+			}
+
+			GLSafeExecute(glDeleteSync, slot.fence);
+			slot.fence = nullptr;
+
+			if (!QueueWrite(slot))
+			{
+				++droppedFrames;
+				slot.session.reset();
+			}
+		}
+	}
+
+	bool QueueWrite(Slot& slot)
+	{
+		GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, slot.pbo);
+		auto mappedData = static_cast<const unsigned char*>(
+			GLSafeExecuteRet(glMapBufferRange, GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(slot.allocatedSize), GL_MAP_READ_BIT)
+		);
+		GLSafeExecute(glBindBuffer, GL_PIXEL_PACK_BUFFER, 0);
+
+		if (!mappedData)
+		{
+			return false;
+		}
+
+		slot.mapped = true;
+		slot.copied = false;
+
+		WriteJob job;
+		job.slot = &slot;
+		job.mappedData = mappedData;
+		job.width = slot.width;
+		job.height = slot.height;
+		job.frameIndex = slot.frameIndex;
+		job.session = slot.session;
+
+		{
+			std::lock_guard<std::mutex> lock(queueMux);
+			writeJobs.push_back(std::move(job));
+		}
+		queueCondVar.notify_one();
+
+		return true;
+	}
+
+	// Mapped data of every queued frame is copied before the next frame is encoded, so buffers are returned quickly
+	void WriterLoop()
+	{
+		std::deque<WriteJob> copiedJobs;
+		std::shared_ptr<const Session> rawSession;
+		std::ofstream rawFile;
+
+		while (true)
+		{
+			std::deque<WriteJob> mappedJobs;
+
+			{
+				std::unique_lock<std::mutex> lock(queueMux);
+				queueCondVar.wait(lock, [this, &copiedJobs]() { return stopWriter || !writeJobs.empty() || !copiedJobs.empty(); });
+
+				if (writeJobs.empty() && copiedJobs.empty())
+				{
+					return;
+				}
+
+				mappedJobs.swap(writeJobs);
+			}
+
+			for (auto& job : mappedJobs)
+			{
+				CopyMappedData(job);
+
+				if (copiedJobs.size() >= MaxQueuedFrames)
+				{
+					++droppedFrames;
+					continue;
+				}
+
+				copiedJobs.push_back(std::move(job));
+			}
+
+			if (copiedJobs.empty())
+			{
+				continue;
+			}
+
+			WriteJob job = std::move(copiedJobs.front());
+			copiedJobs.pop_front();
+
+			if (job.session->format == Format::PNG)
+			{
+				char frameNumber[16];
+				std::snprintf(frameNumber, sizeof(frameNumber), "_%06zu.png", job.frameIndex);
+
+				if (!WritePNG(job.session->path + frameNumber, job.pixels, job.width, job.height))
+				{
+					std::cerr << "Failed to write captured frame " << job.session->path + frameNumber << '\n';
+					continue;
+				}
+			}
+			else
+			{
+				if (rawSession != job.session)
+				{
+					rawFile = std::ofstream(job.session->path, std::ios::out | std::ios::binary);
+					rawSession = job.session;
+				}
+
+				if (!rawFile.write(reinterpret_cast<const char*>(job.pixels.data()), job.pixels.size()))
+				{
+					std::cerr << "Failed to write captured frame to " << job.session->path << '\n';
+					continue;
+				}
+
+				rawFile.flush();
+			}
+
+			++writtenFrames;
+		}
+	}
+
+	// GL rows go from the bottom, both formats expect the top row first
+	void CopyMappedData(WriteJob& job)
+	{
+		const size_t rowSize = static_cast<size_t>(job.width) * 4;
+		job.pixels.resize(rowSize * job.height);
+
+		for (int y = 0; y < job.height; ++y)
+		{
+			std::memcpy(&job.pixels[rowSize * (job.height - 1 - y)], job.mappedData + rowSize * y, rowSize);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(queueMux);
+			job.slot->copied = true;
+		}
+		copyCondVar.notify_all();
+
+		job.slot = nullptr;
+		job.mappedData = nullptr;
+	}
+
+	static unsigned int CRC32(const unsigned char* data, size_t size, unsigned int crc = 0)
+	{
+		static const std::array<unsigned int, 256> table = []()
+		{
+			std::array<unsigned int, 256> res{};
+
+			for (unsigned int i = 0; i < 256; ++i)
+			{
+				unsigned int value = i;
+
+				for (int bit = 0; bit < 8; ++bit)
+				{
+					value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+				}
+
+				res[i] = value;
+			}
+
+			return res;
+		}();
+
+		crc = ~crc;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+
+		return ~crc;
+	}
+
+	static void PutBE32(std::vector<unsigned char>& out, unsigned int value)
+	{
+		out.push_back(static_cast<unsigned char>(value >> 24));
+		out.push_back(static_cast<unsigned char>(value >> 16));
+		out.push_back(static_cast<unsigned char>(value >> 8));
+		out.push_back(static_cast<unsigned char>(value));
+	}
+
+	static void PutChunk(std::vector<unsigned char>& out, const char* type, const std::vector<unsigned char>& data)
+	{
+		PutBE32(out, static_cast<unsigned int>(data.size()));
+
+		const size_t typeStart = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data.begin(), data.end());
+
+		PutBE32(out, CRC32(&out[typeStart], out.size() - typeStart));
+	}
+
+	// RGB PNG with stored (uncompressed) deflate blocks: encoding costs a copy and two checksums,
+	// file size is traded for writer throughput. Alpha of the framebuffer is not meaningful and is dropped
+	static bool WritePNG(const std::string& path, const std::vector<unsigned char>& rgba, int width, int height)
+	{
+		constexpr size_t MaxStoredBlock = 65535;
+
+		std::vector<unsigned char> scanlines;
+		scanlines.reserve((static_cast<size_t>(width) * 3 + 1) * height);
+
+		for (int y = 0; y < height; ++y)
+		{
+			scanlines.push_back(0); // No filter
+
+			const unsigned char* row = &rgba[static_cast<size_t>(y) * width * 4];
+
+			for (int x = 0; x < width; ++x)
+			{
+				scanlines.insert(scanlines.end(), row + x * 4, row + x * 4 + 3);
+			}
+		}
+
+		std::vector<unsigned char> zlib{ 0x78, 0x01 };
+		zlib.reserve(scanlines.size() + scanlines.size() / MaxStoredBlock * 5 + 16);
+
+		unsigned int adlerA = 1;
+		unsigned int adlerB = 0;
+
+		for (size_t offset = 0; offset < scanlines.size() || offset == 0; offset += MaxStoredBlock)
+		{
+			const size_t blockSize = std::min(MaxStoredBlock, scanlines.size() - offset);
+			const bool last = offset + blockSize >= scanlines.size();
+
+			zlib.push_back(last ? 1 : 0);
+			zlib.push_back(static_cast<unsigned char>(blockSize & 0xFF));
+			zlib.push_back(static_cast<unsigned char>(blockSize >> 8));
+			zlib.push_back(static_cast<unsigned char>(~blockSize & 0xFF));
+			zlib.push_back(static_cast<unsigned char>((~blockSize >> 8) & 0xFF));
+			zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+
+			for (size_t i = offset; i < offset + blockSize; ++i)
+			{
+				adlerA = (adlerA + scanlines[i]) % 65521;
+				adlerB = (adlerB + adlerA) % 65521;
+			}
+
+			if (last)
+			{
+				break;
+			}
+		}
+
+		PutBE32(zlib, (adlerB << 16) | adlerA);
+
+		std::vector<unsigned char> header;
+		PutBE32(header, static_cast<unsigned int>(width));
+		PutBE32(header, static_cast<unsigned int>(height));
+		header.insert(header.end(), { 8, 2, 0, 0, 0 }); // 8 bit RGB, no interlace
+
+		std::vector<unsigned char> png{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		PutChunk(png, "IHDR", header);
+		PutChunk(png, "IDAT", zlib);
+		PutChunk(png, "IEND", {});
+
+		std::ofstream file(path, std::ios::out | std::ios::binary);
+
+		return file.is_open() && file.write(reinterpret_cast<const char*>(png.data()), png.size());
+	}
+
+	std::atomic<bool> active = false;
+	std::atomic<size_t> droppedFrames = 0;
+	std::atomic<size_t> writtenFrames = 0;
+
+	std::mutex sessionMux;
+	std::shared_ptr<const Session> pendingSession;
+
+	// Render thread state
+	std::shared_ptr<const Session> currentSession;
+	size_t capturedFrames = 0;
+	bool resourcesCreated = false;
+	std::array<Slot, SlotAmount> slots;
+	size_t nextSlot = 0;
+
+	std::thread writer;
+	bool stopWriter = false;
+	std::mutex queueMux;
+	std::condition_variable queueCondVar;
+	std::condition_variable copyCondVar;
+	std::deque<WriteJob> writeJobs;
+};
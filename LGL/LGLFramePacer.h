@@ -0,0 +1,128 @@
+#pragma once
+
+#include "GLExecutor.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+/*
+	Limits the amount of frames the CPU can run ahead of the GPU with a fence per frame slot.
+	A frame starts once the GPU finished the frame which used its slot before, so CPU preparation
+	of the next frames overlaps GPU execution of the previous ones. Time spent in waits is measured
+*/
+class LGLFramePacer
+{
+public:
+	constexpr static size_t MaxFramesInFlight = 3;
+
+private:
+	// Timeout of a single wait, waits are repeated until the fence is signaled
+	constexpr static GLuint64 WaitTimeoutNs = 1000000000;
+	// Average wait time is measured over this amount of frames
+	constexpr static size_t AveragedFrames = 60;
+
+	std::array<GLsync, MaxFramesInFlight> fences{};
+	std::atomic<size_t> requestedFramesInFlight = 2;
+	size_t framesInFlight = 2;
+	size_t frameSlot = 0;
+
+	std::atomic<float> lastWaitTime = 0.0f;
+	std::atomic<float> averageWaitTime = 0.0f;
+	float accumulatedWaitTime = 0.0f;
+	size_t measuredFrames = 0;
+
+	void WaitForFence(GLsync& fence)
+	{
+		if (!fence)
+		{
+			return;
+		}
+
+		GLenum status = GL_TIMEOUT_EXPIRED;
+
+		while (status == GL_TIMEOUT_EXPIRED)
+		{
+			status = GLSafeExecuteRet(glClientWaitSync, fence, GL_SYNC_FLUSH_COMMANDS_BIT, WaitTimeoutNs);
+		}
+
+		GLSafeExecute(glDeleteSync, fence);
+		fence = nullptr;
+	}
+
+public:
+	// Any thread, applied from the next frame
+	void SetFramesInFlight(size_t amount)
+	{
+		requestedFramesInFlight = std::clamp<size_t>(amount, 1, MaxFramesInFlight);
+	}
+
+	size_t GetFramesInFlight()
+	{
+		return requestedFramesInFlight;
+	}
+
+	// Slot of the current frame, for per frame resources which are rewritten every frame
+	size_t GetFrameSlot()
+	{
+		return frameSlot;
+	}
+
+	// Milliseconds
+	float GetLastWaitTime()
+	{
+		return lastWaitTime;
+	}
+
+	float GetAverageWaitTime()
+	{
+		return averageWaitTime;
+	}
+
+	// Render thread only, with context set. Waits until the slot of the frame is free
+	void BeginFrame()
+	{
+		const auto waitStart = std::chrono::steady_clock::now();
+
+		if (requestedFramesInFlight != framesInFlight)
+		{
+			// Slots are renumbered, so every frame in flight is waited for
+			Release();
+			framesInFlight = requestedFramesInFlight;
+		}
+		else
+		{
+			WaitForFence(fences[frameSlot]);
+		}
+
+		const float waitTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+		lastWaitTime = waitTime;
+		accumulatedWaitTime += waitTime;
+
+		if (++measuredFrames >= AveragedFrames)
+		{
+			averageWaitTime = accumulatedWaitTime / measuredFrames;
+			accumulatedWaitTime = 0.0f;
+			measuredFrames = 0;
+		}
+	}
+
+	// Render thread only, after the frame is submitted
+	void EndFrame()
+	{
+		fences[frameSlot] = GLSafeExecuteRet(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		frameSlot = (frameSlot + 1) % framesInFlight;
+	}
+
+	// Render thread only, with context set. Waits for all frames in flight
+	void Release()
+	{
+		for (size_t i = 0; i < MaxFramesInFlight; ++i)
+		{
+			WaitForFence(fences[(frameSlot + i) % MaxFramesInFlight]);
+		}
+
+		frameSlot = 0;
+	}
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <bitset>
+#include <vector>
+
+/*
+	Input gathered by GLFW callbacks while events are polled, dispatched once per frame afterwards.
+	Key and mouse button states are kept in a bitset and their changes in order of arrival,
+	so presses shorter than a frame are not lost. Cursor movement and scrolling are coalesced into one event per frame
+*/
+class LGLInputState
+{
+public:
+	struct KeyEvent
+	{
+		int key;
+		bool pressed;
+	};
+
+private:
+	// Mouse buttons share the range with keys, codes of keys start above the last button
+	static_assert(GLFW_MOUSE_BUTTON_LAST < GLFW_KEY_SPACE);
+
+	std::bitset<GLFW_KEY_LAST + 1> keyStates;
+	std::vector<KeyEvent> keyEvents;
+
+	bool cursorMoved = false;
+	double cursorX{};
+	double cursorY{};
+
+	bool scrolled = false;
+	double scrollX{};
+	double scrollY{};
+
+public:
+	// Key or mouse button, repeats are not changes of the state
+	void OnKey(int key, int action)
+	{
+		if (key < 0 || key > GLFW_KEY_LAST || action == GLFW_REPEAT)
+		{
+			return;
+		}
+
+		const bool pressed = action == GLFW_PRESS;
+
+		if (keyStates.test(key) == pressed)
+		{
+			return;
+		}
+
+		keyStates.set(key, pressed);
+		keyEvents.push_back({ key, pressed });
+	}
+
+	void OnCursorPosition(double xpos, double ypos)
+	{
+		cursorMoved = true;
+		cursorX = xpos;
+		cursorY = ypos;
+	}
+
+	void OnScroll(double xoffset, double yoffset)
+	{
+		scrolled = true;
+		scrollX += xoffset;
+		scrollY += yoffset;
+	}
+
+	bool IsDown(int key) const
+	{
+		return key >= 0 && key <= GLFW_KEY_LAST && keyStates.test(key);
+	}
+
+	// Changes since the last ClearKeyEvents
+	const std::vector<KeyEvent>& GetKeyEvents() const
+	{
+		return keyEvents;
+	}
+
+	void ClearKeyEvents()
+	{
+		keyEvents.clear();
+	}
+
+	// Last position since the previous call, false if the cursor did not move
+	bool TakeCursorPosition(double& xpos, double& ypos)
+	{
+		if (!cursorMoved)
+		{
+			return false;
+		}
+
+		xpos = cursorX;
+		ypos = cursorY;
+		cursorMoved = false;
+
+		return true;
+	}
+
+	// Sum of offsets since the previous call, false if nothing was scrolled
+	bool TakeScroll(double& xoffset, double& yoffset)
+	{
+		if (!scrolled)
+		{
+			return false;
+		}
+
+		xoffset = scrollX;
+		yoffset = scrollY;
+		scrollX = scrollY = 0.0;
+		scrolled = false;
+
+		return true;
+	}
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "GLExecutor.h"
+
+#include <vector>
+
+/*
+	Framebuffer the frame is rendered to instead of the default one, for windows which are never shown.
+	Hidden windows are not guaranteed to own the pixels of their default framebuffer, an FBO always does
+*/
+class LGLOffscreenTarget
+{
+private:
+	using FBO = unsigned int;
+	using RBO = unsigned int;
+	using TextureID = unsigned int;
+
+	bool resourcesCreated = false;
+	FBO fbo = 0;
+	TextureID colorTex = 0;
+	RBO depthRBO = 0;
+	int allocatedWidth = 0;
+	int allocatedHeight = 0;
+
+	void CreateResources()
+	{
+		GLSafeExecute(glGenFramebuffers, 1, &fbo);
+		GLSafeExecute(glGenTextures, 1, &colorTex);
+		GLSafeExecute(glGenRenderbuffers, 1, &depthRBO);
+
+		resourcesCreated = true;
+	}
+
+	bool AllocateStorage(int width, int height)
+	{
+		GLSafeExecute(glBindTexture, GL_TEXTURE_2D, colorTex);
+		GLSafeExecute(glTexImage2D, GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		GLSafeExecute(glBindTexture, GL_TEXTURE_2D, 0);
+
+		GLSafeExecute(glBindRenderbuffer, GL_RENDERBUFFER, depthRBO);
+		GLSafeExecute(glRenderbufferStorage, GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+		GLSafeExecute(glBindRenderbuffer, GL_RENDERBUFFER, 0);
+
+		GLSafeExecute(glBindFramebuffer, GL_FRAMEBUFFER, fbo);
+		GLSafeExecute(glFramebufferTexture2D, GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+		GLSafeExecute(glFramebufferRenderbuffer, GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+		// Sizes are only kept for a complete framebuffer, so a failed allocation is retried by the next Bind
+		if (GLSafeExecuteRet(glCheckFramebufferStatus, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cerr << "Offscreen framebuffer is incomplete\n";
+			GLSafeExecute(glBindFramebuffer, GL_FRAMEBUFFER, 0);
+
+			allocatedWidth = 0;
+			allocatedHeight = 0;
+
+			return false;
+		}
+
+		allocatedWidth = width;
+		allocatedHeight = height;
+
+		return true;
+	}
+
+public:
+	// Must be called with context set, before the frame is cleared. Leaves the framebuffer bound
+	bool Bind(int width, int height)
+	{
+		if (width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		if (!resourcesCreated)
+		{
+			CreateResources();
+		}
+
+		if (allocatedWidth != width || allocatedHeight != height)
+		{
+			if (!AllocateStorage(width, height))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			GLSafeExecute(glBindFramebuffer, GL_FRAMEBUFFER, fbo);
+		}
+
+		GLSafeExecute(glViewport, 0, 0, width, height);
+
+		return true;
+	}
+
+	FBO GetFBO()
+	{
+		return fbo;
+	}
+
+	// RGBA, rows from the bottom. Stalls until the frame is finished, meant for the last frame only
+	bool ReadPixels(std::vector<unsigned char>& pixels, int& width, int& height)
+	{
+		if (!resourcesCreated || !allocatedWidth || !allocatedHeight)
+		{
+			return false;
+		}
+
+		width = allocatedWidth;
+		height = allocatedHeight;
+		pixels.resize(static_cast<size_t>(width) * height * 4);
+
+		GLSafeExecute(glBindFramebuffer, GL_READ_FRAMEBUFFER, fbo);
+		GLSafeExecute(glPixelStorei, GL_PACK_ALIGNMENT, 4);
+		GLSafeExecute(glReadPixels, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		GLSafeExecute(glBindFramebuffer, GL_READ_FRAMEBUFFER, 0);
+
+		return true;
+	}
+
+	// Must be called with context set
+	void Release()
+	{
+		if (!resourcesCreated)
+		{
+			return;
+		}
+
+		GLSafeExecute(glDeleteFramebuffers, 1, &fbo);
+		GLSafeExecute(glDeleteTextures, 1, &colorTex);
+		GLSafeExecute(glDeleteRenderbuffers, 1, &depthRBO);
+
+		fbo = 0;
+		colorTex = 0;
+		depthRBO = 0;
+		allocatedWidth = 0;
+		allocatedHeight = 0;
+		resourcesCreated = false;
+	}
+};
@@ -169,6 +169,8 @@ namespace LGLStructs
 			BilinearFiltrationConfig BFConfig = {};
 			bool createMipmaps = false;
 			BilinearFiltrationConfig mipmapBFConfig = {};
+			// BC1/BC3 block compression of 3 and 4 channel textures, if supported by the driver
+			bool compress = false;
 		};
 
 		std::string name;
@@ -409,6 +411,7 @@ namespace LGLStructs
 		std::string shaderProgram;
 		const GlyphInfo* glyphInfo;
 		std::function<void()> behaviour;
+		float lineHeight = 15.0f; // Distance between lines of a text with '\n', scaled with the text
 
 		TextInfo() = default;
 
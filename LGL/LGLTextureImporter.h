@@ -0,0 +1,349 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <climits>
+#include <cstdlib>
+
+// S3TC formats are not a part of core profile, defined here in case GLAD was generated without the extension
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+/*
+	CPU side texture import: box filtered mip chain and BC1/BC3 (DXT1/DXT5) block compression.
+	Encoder uses inset bounding box endpoints, trading some quality for import speed
+*/
+class LGLTextureImporter
+{
+public:
+	enum class BlockFormat
+	{
+		None,
+		BC1,
+		BC3
+	};
+
+	struct MipLevel
+	{
+		int width;
+		int height;
+		std::vector<unsigned char> data;
+	};
+
+	struct ImportedTexture
+	{
+		BlockFormat format = BlockFormat::None;
+		std::vector<MipLevel> mips;
+	};
+
+	static ImportedTexture Import(
+		const unsigned char* data,
+		int width,
+		int height,
+		int channelAmount,
+		bool createMipmaps,
+		bool compress
+	)
+	{
+		const size_t baseSize = static_cast<size_t>(width) * height * channelAmount;
+
+		return Import(
+			std::vector<unsigned char>(data, data + baseSize), width, height, channelAmount, createMipmaps, compress
+		);
+	}
+
+	// Passed data becomes the base level as is
+	static ImportedTexture Import(
+		std::vector<unsigned char> data,
+		int width,
+		int height,
+		int channelAmount,
+		bool createMipmaps,
+		bool compress
+	)
+	{
+		ImportedTexture res;
+		res.format = compress ? GetBlockFormat(channelAmount) : BlockFormat::None;
+
+		res.mips.push_back({ width, height, std::move(data) });
+
+		if (createMipmaps)
+		{
+			BuildMipChain(res.mips, channelAmount);
+		}
+
+		if (res.format != BlockFormat::None)
+		{
+			for (auto& mip : res.mips)
+			{
+				mip.data = CompressLevel(mip, channelAmount, res.format);
+			}
+		}
+
+		return res;
+	}
+
+	static BlockFormat GetBlockFormat(int channelAmount)
+	{
+		switch (channelAmount)
+		{
+		case 3:
+			return BlockFormat::BC1;
+		case 4:
+			return BlockFormat::BC3;
+		default:
+			return BlockFormat::None;
+		}
+	}
+
+	static unsigned int GetGLFormat(BlockFormat format)
+	{
+		return format == BlockFormat::BC1 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	}
+
+private:
+	using Pixel = std::array<unsigned char, 4>;
+	using Block = std::array<Pixel, 16>;
+
+	constexpr static int BlockDim = 4;
+
+	static void BuildMipChain(std::vector<MipLevel>& mips, int channelAmount)
+	{
+		while (mips.back().width > 1 || mips.back().height > 1)
+		{
+			const MipLevel& src = mips.back();
+
+			MipLevel dst;
+			dst.width = std::max(1, src.width / 2);
+			dst.height = std::max(1, src.height / 2);
+			dst.data.resize(static_cast<size_t>(dst.width) * dst.height * channelAmount);
+
+			for (int y = 0; y < dst.height; ++y)
+			{
+				const int y0 = std::min(y * 2, src.height - 1);
+				const int y1 = std::min(y * 2 + 1, src.height - 1);
+
+				for (int x = 0; x < dst.width; ++x)
+				{
+					const int x0 = std::min(x * 2, src.width - 1);
+					const int x1 = std::min(x * 2 + 1, src.width - 1);
+
+					for (int c = 0; c < channelAmount; ++c)
+					{
+						auto At = [&src, channelAmount, c](int px, int py)
+						{
+							return static_cast<int>(src.data[(static_cast<size_t>(py) * src.width + px) * channelAmount + c]);
+						};
+
+						int sum = At(x0, y0) + At(x1, y0) + At(x0, y1) + At(x1, y1);
+
+						dst.data[(static_cast<size_t>(y) * dst.width + x) * channelAmount + c] =
+							static_cast<unsigned char>((sum + 2) / 4);
+					}
+				}
+			}
+
+			mips.push_back(std::move(dst));
+		}
+	}
+
+	static std::vector<unsigned char> CompressLevel(const MipLevel& mip, int channelAmount, BlockFormat format)
+	{
+		const size_t blockBytes = format == BlockFormat::BC1 ? 8 : 16;
+		const int blocksX = (mip.width + BlockDim - 1) / BlockDim;
+		const int blocksY = (mip.height + BlockDim - 1) / BlockDim;
+
+		std::vector<unsigned char> res(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+		unsigned char* out = res.data();
+
+		Block block;
+
+		for (int by = 0; by < blocksY; ++by)
+		{
+			for (int bx = 0; bx < blocksX; ++bx)
+			{
+				// Pixels outside of small or non multiple of 4 levels are clamped to the edge
+				for (int i = 0; i < BlockDim * BlockDim; ++i)
+				{
+					const int px = std::min(bx * BlockDim + i % BlockDim, mip.width - 1);
+					const int py = std::min(by * BlockDim + i / BlockDim, mip.height - 1);
+					const unsigned char* src = &mip.data[(static_cast<size_t>(py) * mip.width + px) * channelAmount];
+
+					block[i] = { src[0], src[1], src[2], channelAmount == 4 ? src[3] : static_cast<unsigned char>(255) };
+				}
+
+				if (format == BlockFormat::BC3)
+				{
+					EncodeAlphaBlock(block, out);
+					out += 8;
+				}
+
+				EncodeColorBlock(block, out);
+				out += 8;
+			}
+		}
+
+		return res;
+	}
+
+	static unsigned short To565(int r, int g, int b)
+	{
+		return static_cast<unsigned short>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+	}
+
+	static Pixel From565(unsigned short color)
+	{
+		const int r = (color >> 11) & 0x1F;
+		const int g = (color >> 5) & 0x3F;
+		const int b = color & 0x1F;
+
+		return {
+			static_cast<unsigned char>((r << 3) | (r >> 2)),
+			static_cast<unsigned char>((g << 2) | (g >> 4)),
+			static_cast<unsigned char>((b << 3) | (b >> 2)),
+			255
+		};
+	}
+
+	static void EncodeColorBlock(const Block& block, unsigned char* out)
+	{
+		int minC[3]{ 255, 255, 255 };
+		int maxC[3]{ 0, 0, 0 };
+
+		for (auto& pixel : block)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				minC[c] = std::min(minC[c], static_cast<int>(pixel[c]));
+				maxC[c] = std::max(maxC[c], static_cast<int>(pixel[c]));
+			}
+		}
+
+		// Insetting the box by 1/16 of its size reduces error from outliers defining the endpoints
+		for (int c = 0; c < 3; ++c)
+		{
+			const int inset = (maxC[c] - minC[c]) >> 4;
+			minC[c] = std::min(255, minC[c] + inset);
+			maxC[c] = std::max(0, maxC[c] - inset);
+		}
+
+		unsigned short color0 = To565(maxC[0], maxC[1], maxC[2]);
+		unsigned short color1 = To565(minC[0], minC[1], minC[2]);
+
+		// color0 > color1 selects 4 color mode without punch-through alpha
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+		}
+
+		unsigned int indices = 0;
+
+		if (color0 != color1)
+		{
+			const Pixel c0 = From565(color0);
+			const Pixel c1 = From565(color1);
+
+			Pixel palette[4]{ c0, c1, {}, {} };
+
+			for (int c = 0; c < 3; ++c)
+			{
+				palette[2][c] = static_cast<unsigned char>((2 * c0[c] + c1[c]) / 3);
+				palette[3][c] = static_cast<unsigned char>((c0[c] + 2 * c1[c]) / 3);
+			}
+
+			for (size_t i = 0; i < block.size(); ++i)
+			{
+				unsigned int bestIndex = 0;
+				int bestDistance = INT_MAX;
+
+				for (unsigned int p = 0; p < 4; ++p)
+				{
+					int distance = 0;
+
+					for (int c = 0; c < 3; ++c)
+					{
+						const int diff = static_cast<int>(block[i][c]) - palette[p][c];
+						distance += diff * diff;
+					}
+
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestIndex = p;
+					}
+				}
+
+				indices |= bestIndex << (2 * i);
+			}
+		}
+
+		out[0] = static_cast<unsigned char>(color0 & 0xFF);
+		out[1] = static_cast<unsigned char>(color0 >> 8);
+		out[2] = static_cast<unsigned char>(color1 & 0xFF);
+		out[3] = static_cast<unsigned char>(color1 >> 8);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			out[4 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xFF);
+		}
+	}
+
+	static void EncodeAlphaBlock(const Block& block, unsigned char* out)
+	{
+		int alpha0 = 0;
+		int alpha1 = 255;
+
+		for (auto& pixel : block)
+		{
+			alpha0 = std::max(alpha0, static_cast<int>(pixel[3]));
+			alpha1 = std::min(alpha1, static_cast<int>(pixel[3]));
+		}
+
+		unsigned long long indices = 0;
+
+		// alpha0 > alpha1 selects 8 value interpolation mode
+		if (alpha0 != alpha1)
+		{
+			int palette[8]{ alpha0, alpha1 };
+
+			for (int p = 1; p < 7; ++p)
+			{
+				palette[p + 1] = ((7 - p) * alpha0 + p * alpha1) / 7;
+			}
+
+			for (size_t i = 0; i < block.size(); ++i)
+			{
+				unsigned long long bestIndex = 0;
+				int bestDistance = INT_MAX;
+
+				for (unsigned long long p = 0; p < 8; ++p)
+				{
+					const int distance = std::abs(static_cast<int>(block[i][3]) - palette[p]);
+
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestIndex = p;
+					}
+				}
+
+				indices |= bestIndex << (3 * i);
+			}
+		}
+
+		out[0] = static_cast<unsigned char>(alpha0);
+		out[1] = static_cast<unsigned char>(alpha1);
+
+		for (int i = 0; i < 6; ++i)
+		{
+			out[2 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xFF);
+		}
+	}
+};
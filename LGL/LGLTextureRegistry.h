@@ -0,0 +1,211 @@
+#pragma once
+
+#include "LGLStructs.h"
+
+#include <unordered_map>
+#include <vector>
+#include <optional>
+#include <cstring>
+#include <algorithm>
+
+/*
+	GPU textures shared between models. Textures are keyed by the hash of their content, size and sampling params,
+	so identical textures of different models are uploaded once and released with the last model using them.
+	A texture is shared only if it matches the texture of a model using it byte for byte, no pixels are copied:
+	models keep their texture data anyway, as long as they are not deleted from LGL
+*/
+class LGLTextureRegistry
+{
+public:
+	using TextureID = unsigned int;
+	using TextureKey = size_t;
+
+private:
+	struct SharedTexture
+	{
+		TextureID id;
+		size_t sizeBytes;
+
+		// One per reference. The first one is compared on every hit, so textures with colliding keys are never aliased
+		std::vector<const LGLStructs::Texture*> users;
+	};
+
+	constexpr static size_t FNVOffsetBasis = 0xcbf29ce484222325ull;
+	constexpr static size_t FNVPrime = 0x100000001b3ull;
+
+	std::unordered_map<TextureKey, SharedTexture> textures;
+	size_t savedBytes = 0;
+
+	static void HashBytes(size_t& hash, const unsigned char* data, size_t size)
+	{
+		// Hashed by 8 byte words, byte by byte FNV is too slow for multi megabyte textures
+		size_t i = 0;
+
+		for (; i + sizeof(size_t) <= size; i += sizeof(size_t))
+		{
+			size_t word;
+			std::memcpy(&word, data + i, sizeof(size_t));
+
+			hash ^= word;
+			hash *= FNVPrime;
+		}
+
+		for (; i < size; ++i)
+		{
+			hash ^= data[i];
+			hash *= FNVPrime;
+		}
+	}
+
+	template<typename Type>
+	static void HashValue(size_t& hash, const Type& value)
+	{
+		HashBytes(hash, reinterpret_cast<const unsigned char*>(&value), sizeof(Type));
+	}
+
+	static size_t GetDataSize(const LGLStructs::Texture& texture)
+	{
+		return static_cast<size_t>(texture.width) * texture.height * texture.channelAmount;
+	}
+
+	static bool IsSameTexture(const LGLStructs::Texture& sharedTexture, const LGLStructs::Texture& texture)
+	{
+		const auto& lhs = sharedTexture.params;
+		const auto& rhs = texture.params;
+
+		return
+			sharedTexture.width == texture.width &&
+			sharedTexture.height == texture.height &&
+			sharedTexture.channelAmount == texture.channelAmount &&
+			lhs.overlay == rhs.overlay &&
+			lhs.BFConfig.minFilter == rhs.BFConfig.minFilter &&
+			lhs.BFConfig.maxFilter == rhs.BFConfig.maxFilter &&
+			lhs.createMipmaps == rhs.createMipmaps &&
+			lhs.mipmapBFConfig.minFilter == rhs.mipmapBFConfig.minFilter &&
+			lhs.mipmapBFConfig.maxFilter == rhs.mipmapBFConfig.maxFilter &&
+			lhs.compress == rhs.compress &&
+			(sharedTexture.data == texture.data || !std::memcmp(sharedTexture.data, texture.data, GetDataSize(texture)));
+	}
+
+public:
+	// Texture must have data
+	static TextureKey GetKey(const LGLStructs::Texture& texture)
+	{
+		size_t hash = FNVOffsetBasis;
+
+		HashValue(hash, texture.width);
+		HashValue(hash, texture.height);
+		HashValue(hash, texture.channelAmount);
+		HashValue(hash, texture.params.overlay);
+		HashValue(hash, texture.params.BFConfig.minFilter);
+		HashValue(hash, texture.params.BFConfig.maxFilter);
+		HashValue(hash, texture.params.createMipmaps);
+		HashValue(hash, texture.params.mipmapBFConfig.minFilter);
+		HashValue(hash, texture.params.mipmapBFConfig.maxFilter);
+		HashValue(hash, texture.params.compress);
+
+		HashBytes(hash, texture.data, GetDataSize(texture));
+
+		return hash;
+	}
+
+	// Approximate size the texture takes on GPU, with mip chain and block compression accounted
+	static size_t GetVRAMSize(const LGLStructs::Texture& texture, bool compressed)
+	{
+		size_t size = static_cast<size_t>(texture.width) * texture.height;
+
+		// BC1 takes half a byte per pixel, BC3 a byte
+		size = compressed ? (texture.channelAmount == 4 ? size : size / 2) : size * texture.channelAmount;
+
+		return texture.params.createMipmaps ? size * 4 / 3 : size;
+	}
+
+	// Takes a reference to the texture if an identical one is registered, 'texture' must stay valid until released
+	std::optional<TextureID> Acquire(TextureKey key, const LGLStructs::Texture& texture)
+	{
+		auto textureIter = textures.find(key);
+
+		if (textureIter == textures.end() || !IsSameTexture(*textureIter->second.users.front(), texture))
+		{
+			return std::nullopt;
+		}
+
+		textureIter->second.users.push_back(&texture);
+		savedBytes += textureIter->second.sizeBytes;
+
+		return textureIter->second.id;
+	}
+
+	// Key is taken by a different texture if Acquire failed for a registered key, such textures are not shared
+	bool IsRegistered(TextureKey key)
+	{
+		return textures.contains(key);
+	}
+
+	// 'texture' must stay valid until released
+	void Register(TextureKey key, TextureID id, size_t sizeBytes, const LGLStructs::Texture& texture)
+	{
+		textures[key] = { id, sizeBytes, { &texture } };
+	}
+
+	// For textures registered with a placeholder, once their upload is finished
+	bool UpdateID(TextureKey key, TextureID id)
+	{
+		auto textureIter = textures.find(key);
+
+		if (textureIter == textures.end())
+		{
+			return false;
+		}
+
+		textureIter->second.id = id;
+
+		return true;
+	}
+
+	// Reference of 'texture' taken by Acquire or Register. Returns ID of the texture if the last reference 
+	// is released and the texture has to be deleted
+	std::optional<TextureID> Release(TextureKey key, const LGLStructs::Texture* texture)
+	{
+		auto textureIter = textures.find(key);
+
+		if (textureIter == textures.end())
+		{
+			return std::nullopt;
+		}
+
+		auto& users = textureIter->second.users;
+		auto userIter = std::find(users.begin(), users.end(), texture);
+
+		users.erase(userIter != users.end() ? userIter : users.begin());
+
+		if (!users.empty())
+		{
+			savedBytes -= std::min(savedBytes, textureIter->second.sizeBytes);
+
+			return std::nullopt;
+		}
+
+		TextureID id = textureIter->second.id;
+		textures.erase(textureIter);
+
+		return id;
+	}
+
+	// Amount of texture data not uploaded thanks to sharing
+	size_t GetSavedBytes()
+	{
+		return savedBytes;
+	}
+
+	size_t GetTextureAmount()
+	{
+		return textures.size();
+	}
+
+	void Clear()
+	{
+		textures.clear();
+		savedBytes = 0;
+	}
+};
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "GLExecutor.h"
+#include "LGLTextureImporter.h"
+#include "LGLTextureUploader.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+
+/*
+	Keeps CPU copies of uploaded mip chains and manages which levels of them are resident on GPU.
+	Textures start from their low resolution levels, finer levels are streamed in while models using them
+	cover enough of the screen, and top levels of textures not sampled recently are evicted to stay under the budget
+*/
+class LGLTextureStreamer
+{
+private:
+	using TextureID = unsigned int;
+
+	struct StreamedTexture
+	{
+		std::string modelName;
+		unsigned int textureFormat;
+		LGLTextureImporter::ImportedTexture importedTexture;
+		int initialLevel;
+		int residentLevel; // Finest level resident on GPU, coarser ones are always resident
+		int uploadRow = 0; // Progress of residentLevel - 1 upload
+		size_t lastSampledFrame = 0;
+	};
+
+	// Textures are created with levels not larger than this, the rest is streamed
+	constexpr static int InitialMaxDimension = 64;
+	// Texture is considered unused, and can lose its top levels, after this amount of frames without sampling
+	constexpr static size_t IdleFrames = 120;
+
+	std::unordered_map<TextureID, StreamedTexture> textures;
+	std::unordered_map<std::string, float> modelScreenSizes;
+
+	size_t vramBudget = 256 * 1024 * 1024;
+	size_t residentBytes = 0;
+	size_t currentFrame = 0;
+
+	static size_t GetLevelSize(const StreamedTexture& texture, int level)
+	{
+		return texture.importedTexture.mips[level].data.size();
+	}
+
+	// Level whose texel density matches the screen size of the model: one texel per pixel
+	int GetDesiredLevel(const StreamedTexture& texture)
+	{
+		auto screenSizeIter = modelScreenSizes.find(texture.modelName);
+
+		if (screenSizeIter == modelScreenSizes.end())
+		{
+			return 0;
+		}
+
+		if (screenSizeIter->second <= 0.0f)
+		{
+			return texture.initialLevel;
+		}
+
+		const auto& baseMip = texture.importedTexture.mips.front();
+		const float texelsPerPixel = std::max(baseMip.width, baseMip.height) / screenSizeIter->second;
+		const int level = texelsPerPixel > 1.0f ? static_cast<int>(std::floor(std::log2(texelsPerPixel))) : 0;
+
+		return std::clamp(level, 0, texture.initialLevel);
+	}
+
+	void FreeLevel(TextureID textureID, StreamedTexture& texture, int level)
+	{
+		const bool compressed = texture.importedTexture.format != LGLTextureImporter::BlockFormat::None;
+		const unsigned int internalFormat =
+			compressed ? LGLTextureImporter::GetGLFormat(texture.importedTexture.format) : texture.textureFormat;
+
+		GLSafeExecute(glBindTexture, GL_TEXTURE_2D, textureID);
+		GLSafeExecute(
+			glTexImage2D, GL_TEXTURE_2D, level, internalFormat, 0, 0, 0, texture.textureFormat, GL_UNSIGNED_BYTE, nullptr
+		);
+
+		residentBytes -= std::min(residentBytes, GetLevelSize(texture, level));
+	}
+
+	// Drops the finest level of the texture, or the partially uploaded one if there is any
+	bool EvictTopLevel(TextureID textureID, StreamedTexture& texture)
+	{
+		if (texture.uploadRow)
+		{
+			FreeLevel(textureID, texture, texture.residentLevel - 1);
+			texture.uploadRow = 0;
+
+			return true;
+		}
+
+		if (texture.residentLevel >= texture.initialLevel)
+		{
+			return false;
+		}
+
+		FreeLevel(textureID, texture, texture.residentLevel);
+		++texture.residentLevel;
+		GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, texture.residentLevel);
+
+		return true;
+	}
+
+	// Least recently sampled textures lose their top levels first, textures in use are never evicted
+	bool EvictUntilFits(size_t requiredBytes, TextureID requester)
+	{
+		std::vector<std::pair<size_t, TextureID>> candidates;
+
+		for (auto& [textureID, texture] : textures)
+		{
+			const bool overDetailed = texture.residentLevel < GetDesiredLevel(texture);
+
+			if (textureID != requester && (currentFrame - texture.lastSampledFrame > IdleFrames || overDetailed))
+			{
+				candidates.push_back({ texture.lastSampledFrame, textureID });
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+
+		for (auto& [_, textureID] : candidates)
+		{
+			StreamedTexture& texture = textures[textureID];
+
+			while (residentBytes + requiredBytes > vramBudget && EvictTopLevel(textureID, texture));
+
+			if (residentBytes + requiredBytes <= vramBudget)
+			{
+				return true;
+			}
+		}
+
+		return residentBytes + requiredBytes <= vramBudget;
+	}
+
+public:
+	static int GetInitialLevel(const LGLTextureImporter::ImportedTexture& importedTexture)
+	{
+		for (size_t level = 0; level < importedTexture.mips.size(); ++level)
+		{
+			const auto& mip = importedTexture.mips[level];
+
+			if (std::max(mip.width, mip.height) <= InitialMaxDimension)
+			{
+				return static_cast<int>(level);
+			}
+		}
+
+		return static_cast<int>(importedTexture.mips.size()) - 1;
+	}
+
+	void SetBudget(size_t bytes)
+	{
+		vramBudget = bytes;
+	}
+
+	size_t GetResidentBytes()
+	{
+		return residentBytes;
+	}
+
+	// Levels from residentLevel down must already be uploaded, with GL_TEXTURE_BASE_LEVEL set to residentLevel
+	void Add(
+		TextureID textureID,
+		const std::string& modelName,
+		unsigned int textureFormat,
+		LGLTextureImporter::ImportedTexture&& importedTexture,
+		int residentLevel
+	)
+	{
+		StreamedTexture texture{ modelName, textureFormat, std::move(importedTexture), residentLevel, residentLevel };
+		texture.lastSampledFrame = currentFrame;
+
+		for (int level = residentLevel; level < static_cast<int>(texture.importedTexture.mips.size()); ++level)
+		{
+			residentBytes += GetLevelSize(texture, level);
+		}
+
+		textures[textureID] = std::move(texture);
+	}
+
+	// GL texture itself is owned by LGL, only the tracking is dropped
+	void Remove(TextureID textureID)
+	{
+		auto textureIter = textures.find(textureID);
+
+		if (textureIter == textures.end())
+		{
+			return;
+		}
+
+		StreamedTexture& texture = textureIter->second;
+
+		for (int level = texture.residentLevel; level < static_cast<int>(texture.importedTexture.mips.size()); ++level)
+		{
+			residentBytes -= std::min(residentBytes, GetLevelSize(texture, level));
+		}
+
+		if (texture.uploadRow)
+		{
+			residentBytes -= std::min(residentBytes, GetLevelSize(texture, texture.residentLevel - 1));
+		}
+
+		textures.erase(textureIter);
+	}
+
+	void RemoveModelScreenSize(const std::string& modelName)
+	{
+		modelScreenSizes.erase(modelName);
+	}
+
+	void Clear()
+	{
+		textures.clear();
+		modelScreenSizes.clear();
+		residentBytes = 0;
+	}
+
+	void MarkSampled(TextureID textureID)
+	{
+		auto textureIter = textures.find(textureID);
+
+		if (textureIter != textures.end())
+		{
+			textureIter->second.lastSampledFrame = currentFrame;
+		}
+	}
+
+	// Largest size in pixels the model currently covers on screen, 0 if it is not visible
+	void SetModelScreenSize(const std::string& modelName, float screenSize)
+	{
+		modelScreenSizes[modelName] = screenSize;
+	}
+
+	// Render thread only, with context set. Streams in one level at a time per texture within the budget
+	void Process(LGLTextureUploader& uploader, size_t budgetBytes)
+	{
+		++currentFrame;
+
+		for (auto& [textureID, texture] : textures)
+		{
+			if (!budgetBytes)
+			{
+				break;
+			}
+
+			if (currentFrame - texture.lastSampledFrame > IdleFrames || GetDesiredLevel(texture) >= texture.residentLevel)
+			{
+				continue;
+			}
+
+			const int level = texture.residentLevel - 1;
+			const auto& mip = texture.importedTexture.mips[level];
+
+			if (!texture.uploadRow)
+			{
+				if (!EvictUntilFits(GetLevelSize(texture, level), textureID))
+				{
+					continue;
+				}
+
+				residentBytes += GetLevelSize(texture, level);
+			}
+
+			GLSafeExecute(glBindTexture, GL_TEXTURE_2D, textureID);
+
+			const size_t sentBytes = uploader.UploadMipRows(
+				mip, level, texture.importedTexture.format, texture.textureFormat, texture.uploadRow, budgetBytes
+			);
+			budgetBytes -= std::min(budgetBytes, sentBytes);
+
+			if (texture.uploadRow >= mip.height)
+			{
+				texture.uploadRow = 0;
+				texture.residentLevel = level;
+				GLSafeExecute(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+			}
+		}
+
+		GLSafeExecute(glBindTexture, GL_TEXTURE_2D, 0);
+	}
+};
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "GLExecutor.h"
+#include "LGLTextureImporter.h"
+#include "LGLStructs.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <array>
+#include <cstring>
+#include <functional>
+
+/*
+	Prepares textures (mip chain, compression) on a worker thread and stages finished ones
+	for the render thread, which uploads them through a ring of pixel buffer objects
+*/
+class LGLTextureUploader
+{
+public:
+	struct UploadJob
+	{
+		std::string modelName;
+		std::string textureName;
+		size_t textureKey;
+		LGLStructs::Texture::TextureParams params;
+		int width;
+		int height;
+		int channelAmount;
+		bool compress;
+		std::vector<unsigned char> sourceData;
+
+		LGLTextureImporter::ImportedTexture importedTexture;
+
+		// Render thread upload progress
+		unsigned int textureID = 0;
+		size_t firstLevel = 0;
+		size_t currentLevel = 0;
+		int currentRow = 0;
+
+		std::atomic<bool> cancelled = false;
+	};
+
+	LGLTextureUploader()
+	{
+		worker = std::thread([this]() { WorkerLoop(); });
+	}
+
+	~LGLTextureUploader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(jobMux);
+			stopWorker = true;
+		}
+		jobCondVar.notify_one();
+		worker.join();
+	}
+
+	// Called by the worker thread once a prepared texture is ready to be uploaded
+	void SetReadyCallback(std::function<void()> readyFunc)
+	{
+		std::lock_guard<std::mutex> lock(jobMux);
+		this->readyFunc = std::move(readyFunc);
+	}
+
+	// Texture data is copied, caller is free to release it after the call
+	void Queue(const std::string& modelName, const LGLStructs::Texture& texture, size_t textureKey, bool compress)
+	{
+		auto job = std::make_shared<UploadJob>();
+		job->modelName = modelName;
+		job->textureName = texture.name;
+		job->textureKey = textureKey;
+		job->params = texture.params;
+		job->width = texture.width;
+		job->height = texture.height;
+		job->channelAmount = texture.channelAmount;
+		job->compress = compress;
+		job->sourceData.assign(
+			texture.data, texture.data + static_cast<size_t>(texture.width) * texture.height * texture.channelAmount
+		);
+
+		{
+			std::lock_guard<std::mutex> lock(jobMux);
+			pendingJobs.push_back(std::move(job));
+		}
+		jobCondVar.notify_one();
+	}
+
+	void Cancel(size_t textureKey)
+	{
+		std::lock_guard<std::mutex> pendingLock(jobMux);
+		std::lock_guard<std::mutex> readyLock(readyMux);
+
+		for (auto* jobs : { &pendingJobs, &readyJobs })
+		{
+			for (auto& job : *jobs)
+			{
+				if (job->textureKey == textureKey)
+				{
+					job->cancelled = true;
+				}
+			}
+		}
+
+		if (activeJob && activeJob->textureKey == textureKey)
+		{
+			activeJob->cancelled = true;
+		}
+	}
+
+	void CancelAll()
+	{
+		std::lock_guard<std::mutex> pendingLock(jobMux);
+		std::lock_guard<std::mutex> readyLock(readyMux);
+
+		for (auto* jobs : { &pendingJobs, &readyJobs })
+		{
+			for (auto& job : *jobs)
+			{
+				job->cancelled = true;
+			}
+		}
+
+		if (activeJob)
+		{
+			activeJob->cancelled = true;
+		}
+	}
+
+	// Render thread only. Job stays at the front until popped, so it can be uploaded over several frames
+	std::shared_ptr<UploadJob> GetReadyJob()
+	{
+		std::lock_guard<std::mutex> lock(readyMux);
+
+		return readyJobs.empty() ? nullptr : readyJobs.front();
+	}
+
+	void PopReadyJob()
+	{
+		std::lock_guard<std::mutex> lock(readyMux);
+
+		if (!readyJobs.empty())
+		{
+			readyJobs.pop_front();
+		}
+	}
+
+	// Copies data into the next PBO of the ring and leaves it bound to GL_PIXEL_UNPACK_BUFFER
+	// Returns pointer to pass to glTex(Sub)Image calls: offset into the PBO, or data itself if mapping failed
+	const void* StageToPBO(const unsigned char* data, size_t size)
+	{
+		if (!pbosCreated)
+		{
+			GLSafeExecute(glGenBuffers, static_cast<int>(PBOAmount), pbos.data());
+			pbosCreated = true;
+		}
+
+		currentPBO = (currentPBO + 1) % PBOAmount;
+		GLSafeExecute(glBindBuffer, GL_PIXEL_UNPACK_BUFFER, pbos[currentPBO]);
+
+		// Orphaning the storage, driver does not wait for previous transfer from this buffer to finish
+		GLSafeExecute(glBufferData, GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+		void* mapped = GLSafeExecuteRet(
+			glMapBufferRange, GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size),
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+		);
+
+		if (mapped)
+		{
+			std::memcpy(mapped, data, size);
+			GLSafeExecute(glUnmapBuffer, GL_PIXEL_UNPACK_BUFFER);
+
+			return nullptr;
+		}
+
+		GLSafeExecute(glBindBuffer, GL_PIXEL_UNPACK_BUFFER, 0);
+
+		return data;
+	}
+
+	// Render thread only, texture must be bound. Uploads rows of the level starting from currentRow,
+	// storage of the level is specified on the first rows. At least one row (or row of blocks) is sent regardless of the budget
+	// Returns amount of bytes sent, currentRow is advanced
+	size_t UploadMipRows(
+		const LGLTextureImporter::MipLevel& mip,
+		int level,
+		LGLTextureImporter::BlockFormat blockFormat,
+		unsigned int textureFormat,
+		int& currentRow,
+		size_t budgetBytes
+	)
+	{
+		const bool compressed = blockFormat != LGLTextureImporter::BlockFormat::None;
+
+		// Compressed data can only be sent by rows of 4x4 blocks
+		const int rowsPerUnit = compressed ? 4 : 1;
+		const int unitAmount = (mip.height + rowsPerUnit - 1) / rowsPerUnit;
+		const size_t unitSize = mip.data.size() / unitAmount;
+
+		if (currentRow == 0)
+		{
+			const unsigned int internalFormat = compressed ? LGLTextureImporter::GetGLFormat(blockFormat) : textureFormat;
+
+			GLSafeExecute(
+				glTexImage2D, GL_TEXTURE_2D, level, internalFormat, mip.width, mip.height, 0, textureFormat,
+				GL_UNSIGNED_BYTE, nullptr
+			);
+		}
+
+		const int currentUnit = currentRow / rowsPerUnit;
+		const int unitsToSend = std::min(unitAmount - currentUnit, std::max(1, static_cast<int>(budgetBytes / unitSize)));
+		const size_t bytesToSend = unitSize * unitsToSend;
+		const int rowsToSend = std::min(unitsToSend * rowsPerUnit, mip.height - currentRow);
+
+		GLSafeExecute(glPixelStorei, GL_UNPACK_ALIGNMENT, textureFormat != GL_RGBA ? 1 : 4);
+		const void* pixels = StageToPBO(mip.data.data() + unitSize * currentUnit, bytesToSend);
+
+		if (compressed)
+		{
+			GLSafeExecute(
+				glCompressedTexSubImage2D, GL_TEXTURE_2D, level, 0, currentRow, mip.width, rowsToSend,
+				LGLTextureImporter::GetGLFormat(blockFormat), static_cast<int>(bytesToSend), pixels
+			);
+		}
+		else
+		{
+			GLSafeExecute(
+				glTexSubImage2D, GL_TEXTURE_2D, level, 0, currentRow, mip.width, rowsToSend,
+				textureFormat, GL_UNSIGNED_BYTE, pixels
+			);
+		}
+
+		GLSafeExecute(glBindBuffer, GL_PIXEL_UNPACK_BUFFER, 0);
+
+		currentRow += rowsToSend;
+
+		return bytesToSend;
+	}
+
+	// Render thread only, with context set
+	void Release()
+	{
+		CancelAll();
+
+		while (auto job = GetReadyJob())
+		{
+			if (job->textureID)
+			{
+				GLSafeExecute(glDeleteTextures, 1, &job->textureID);
+			}
+			PopReadyJob();
+		}
+
+		if (pbosCreated)
+		{
+			GLSafeExecute(glDeleteBuffers, static_cast<int>(PBOAmount), pbos.data());
+			pbosCreated = false;
+		}
+	}
+
+private:
+	constexpr static size_t PBOAmount = 3;
+
+	void WorkerLoop()
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(jobMux);
+				jobCondVar.wait(lock, [this]() { return stopWorker || !pendingJobs.empty(); });
+
+				if (stopWorker)
+				{
+					return;
+				}
+
+				activeJob = std::move(pendingJobs.front());
+				pendingJobs.pop_front();
+			}
+
+			if (!activeJob->cancelled)
+			{
+				activeJob->importedTexture = LGLTextureImporter::Import(
+					std::move(activeJob->sourceData),
+					activeJob->width,
+					activeJob->height,
+					activeJob->channelAmount,
+					activeJob->params.createMipmaps,
+					activeJob->compress
+				);
+			}
+
+			std::function<void()> currentReadyFunc;
+
+			{
+				std::lock_guard<std::mutex> pendingLock(jobMux);
+				std::lock_guard<std::mutex> readyLock(readyMux);
+
+				if (!activeJob->cancelled)
+				{
+					readyJobs.push_back(std::move(activeJob));
+					currentReadyFunc = readyFunc;
+				}
+				activeJob.reset();
+			}
+
+			if (currentReadyFunc)
+			{
+				currentReadyFunc();
+			}
+		}
+	}
+
+	std::thread worker;
+	bool stopWorker = false;
+	std::function<void()> readyFunc;
+
+	std::mutex jobMux;
+	std::condition_variable jobCondVar;
+	std::deque<std::shared_ptr<UploadJob>> pendingJobs;
+	std::shared_ptr<UploadJob> activeJob;
+
+	std::mutex readyMux;
+	std::deque<std::shared_ptr<UploadJob>> readyJobs;
+
+	bool pbosCreated = false;
+	size_t currentPBO = 0;
+	std::array<unsigned int, PBOAmount> pbos{};
+};
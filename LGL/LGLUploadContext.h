@@ -0,0 +1,211 @@
+#pragma once
+
+#include "GLExecutor.h"
+
+#include <GLFW/glfw3.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+
+/*
+	Loader GL context shared with the main one, owned by a dedicated thread which executes uploads with it.
+	A fence is placed after every upload and the render thread runs the completion of the upload only once
+	the fence is signaled, so buffers and textures never become visible to rendering half written.
+	Container objects (VAOs) are not shared between contexts, completions are expected to create them
+*/
+class LGLUploadContext
+{
+	struct Upload
+	{
+		std::function<void()> upload;
+		std::function<void()> onComplete;
+		GLsync fence = nullptr;
+	};
+
+	GLFWwindow* loaderWindow = nullptr;
+	std::thread loader;
+	std::function<void()> uploadFinishedFunc;
+
+	std::mutex uploadMux;
+	std::condition_variable uploadCondVar;
+	std::deque<Upload> pendingUploads;
+	bool stopLoader = false;
+
+	std::mutex finishedMux;
+	std::deque<Upload> finishedUploads;
+
+	void LoaderLoop()
+	{
+		glfwMakeContextCurrent(loaderWindow);
+
+		while (true)
+		{
+			Upload current;
+
+			{
+				std::unique_lock<std::mutex> lock(uploadMux);
+				uploadCondVar.wait(lock, [this]() { return stopLoader || !pendingUploads.empty(); });
+
+				// Queued uploads are finished before stopping, so none of the completions is lost
+				if (pendingUploads.empty())
+				{
+					break;
+				}
+
+				current = std::move(pendingUploads.front());
+				pendingUploads.pop_front();
+			}
+
+			current.upload();
+
+			current.fence = GLSafeExecuteRet(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			// Fence has to reach the GPU, otherwise the render thread could wait for it forever
+			GLSafeExecute(glFlush);
+
+			{
+				std::lock_guard<std::mutex> lock(finishedMux);
+				finishedUploads.push_back(std::move(current));
+			}
+
+			if (uploadFinishedFunc)
+			{
+				uploadFinishedFunc();
+			}
+		}
+
+		glfwMakeContextCurrent(nullptr);
+	}
+
+	void CompleteUpload(Upload& finished)
+	{
+		GLSafeExecute(glDeleteSync, finished.fence);
+
+		if (finished.onComplete)
+		{
+			finished.onComplete();
+		}
+	}
+
+public:
+	~LGLUploadContext()
+	{
+		Stop();
+	}
+
+	bool IsRunning()
+	{
+		return loaderWindow != nullptr;
+	}
+
+	// Thread which created the main window only, GLFW windows can not be created elsewhere.
+	// 'visibleHint' is the GLFW_VISIBLE value restored after the hidden loader window is created.
+	// 'uploadFinishedFunc' is called by the loader thread after every upload
+	bool Start(GLFWwindow* mainWindow, int visibleHint, std::function<void()> uploadFinishedFunc = nullptr)
+	{
+		if (IsRunning())
+		{
+			return true;
+		}
+
+		// Context hints of the main window still apply, so the loader context is created compatible with it
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		loaderWindow = glfwCreateWindow(1, 1, "", nullptr, mainWindow);
+		glfwWindowHint(GLFW_VISIBLE, visibleHint);
+
+		if (!loaderWindow)
+		{
+			std::cout << "Failed to create loader context\n";
+			return false;
+		}
+
+		this->uploadFinishedFunc = uploadFinishedFunc;
+		stopLoader = false;
+		loader = std::thread(&LGLUploadContext::LoaderLoop, this);
+
+		return true;
+	}
+
+	// Any thread. 'upload' is executed on the loader thread with only GL calls allowed,
+	// 'onComplete' on the render thread once the GPU is done with the upload
+	void Queue(std::function<void()> upload, std::function<void()> onComplete)
+	{
+		{
+			std::lock_guard<std::mutex> lock(uploadMux);
+			pendingUploads.push_back({ std::move(upload), std::move(onComplete) });
+		}
+		uploadCondVar.notify_one();
+	}
+
+	// Render thread only, with context set. Completions are run in the order of uploads,
+	// the first one with its fence not signaled yet stops the processing until the next call
+	size_t ProcessFinished()
+	{
+		size_t completedAmount = 0;
+
+		while (true)
+		{
+			Upload finished;
+
+			{
+				std::lock_guard<std::mutex> lock(finishedMux);
+
+				if (finishedUploads.empty())
+				{
+					break;
+				}
+
+				const GLenum status = GLSafeExecuteRet(glClientWaitSync, finishedUploads.front().fence, 0, 0);
+
+				if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				{
+					break;
+				}
+
+				finished = std::move(finishedUploads.front());
+				finishedUploads.pop_front();
+			}
+
+			CompleteUpload(finished);
+			++completedAmount;
+		}
+
+		return completedAmount;
+	}
+
+	size_t GetPendingAmount()
+	{
+		std::lock_guard<std::mutex> uploadLock(uploadMux);
+		std::lock_guard<std::mutex> finishedLock(finishedMux);
+
+		return pendingUploads.size() + finishedUploads.size();
+	}
+
+	// Thread which called Start, with the main context set. Queued uploads are finished and completed
+	void Stop()
+	{
+		if (!IsRunning())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(uploadMux);
+			stopLoader = true;
+		}
+		uploadCondVar.notify_one();
+		loader.join();
+
+		for (auto& finished : finishedUploads)
+		{
+			GLSafeExecuteRet(glClientWaitSync, finished.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			CompleteUpload(finished);
+		}
+		finishedUploads.clear();
+
+		glfwDestroyWindow(loaderWindow);
+		loaderWindow = nullptr;
+	}
+};
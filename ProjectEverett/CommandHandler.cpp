@@ -43,8 +43,9 @@ void CommandHandler::RunCommandLine()
 	std::string input;
 	std::getline(std::cin, input);
 
-	std::string command = input.substr(0, input.find(' '));
-	std::string arg = input.substr(input.find(' ') + 1, std::string::npos);
+	const size_t separator = input.find(' ');
+	std::string command = input.substr(0, separator);
+	std::string arg = separator != std::string::npos ? input.substr(separator + 1) : "";
 
 	commands.at(command)(arg);
 
@@ -1,35 +1,38 @@
 #pragma once
 
 #include <iostream>
-#include <functional>
-#include <list>
+#include <string>
+#include <string_view>
 
+#include "LogSystem.h"
+
+// Stream buffer passing every line written to it as a message of the log system
 class CustomOutput
 {
 private:
 	class StreambufSubstitute final : public std::streambuf
 	{
-	public:
-		using EndlineCallbackFunc = std::function<void(const std::string&)>;
-	private:
 		static inline thread_local std::string lineToSend;
 
-		std::map<std::string, std::pair<EndlineCallbackFunc, bool>> endlineCallbacks;
-		std::list<std::string> delayedOutputList;
-		bool manualOutputEnabled = false;
+		LogSystem& logSystem;
+		LogSystem::FilteredLog log; // Lines below the compiled level are not logged at all
+
+		void SendLine()
+		{
+			(logSystem.*log)(lineToSend);
+			lineToSend.clear();
+		}
 
 		int overflow(int c) override
 		{
-			if (c == '\n')
+			if (c == traits_type::eof())
 			{
-				ExecuteCallbacks(false);
-
-				if (manualOutputEnabled)
-				{
-					delayedOutputList.push_back(lineToSend);
-				}
+				return traits_type::not_eof(c);
+			}
 
-				lineToSend.clear();
+			if (c == '\n')
+			{
+				SendLine();
 			}
 			else
 			{
@@ -38,57 +41,33 @@ private:
 
 			return c;
 		}
-	public:
-		using EndlineCallbackFunc = std::function<void(const std::string&)>;
-
-		void SetEndlineCallback(
-			const std::string& key, const StreambufSubstitute::EndlineCallbackFunc endlineCallback, bool manualExecution
-		)
-		{
-			if (manualExecution)
-			{
-				manualOutputEnabled = true;
-			}
-
-			endlineCallbacks.emplace(key, std::pair<EndlineCallbackFunc, bool>{ endlineCallback, manualExecution });
-		}
 
-		void RemoveEndlineCallback(const std::string& key)
+		// Whole strings at once instead of a character per call
+		std::streamsize xsputn(const char* s, std::streamsize count) override
 		{
-			endlineCallbacks.erase(key);
-		}
+			std::string_view text(s, static_cast<size_t>(count));
 
-		void ExecuteCallbacks(bool manual)
-		{
-			if (manual && delayedOutputList.empty())
+			for (size_t lineEnd = text.find('\n'); lineEnd != std::string_view::npos; lineEnd = text.find('\n'))
 			{
-				return;
+				lineToSend.append(text.substr(0, lineEnd));
+				SendLine();
+				text.remove_prefix(lineEnd + 1);
 			}
 
-			for (auto& [_, callbackPair] : endlineCallbacks)
-			{
-				if (manual && callbackPair.second)
-				{
-					for (auto& str : delayedOutputList)
-					{
-						callbackPair.first(str);
-					}
-				}
-				else if (!callbackPair.second)
-				{
-					callbackPair.first(lineToSend);
-				}
-			}
+			lineToSend.append(text);
 
-			if (manual)
-			{
-				delayedOutputList.clear();
-			}
+			return count;
 		}
+
+	public:
+		StreambufSubstitute(LogSystem& logSystem, LogSystem::Level level)
+			: logSystem(logSystem), log(LogSystem::GetFilteredLog(level))
+		{}
 	};
 
 public:
-	CustomOutput()
+	CustomOutput(LogSystem& logSystem, LogSystem::Level level)
+		: sSub(logSystem, level)
 	{
 		ostream = std::make_unique<std::ostream>(&sSub);
 	}
@@ -97,24 +76,7 @@ public:
 	{
 		return ostream->rdbuf();
 	}
-
-	void SetEndlineCallback(
-		const std::string& key, const StreambufSubstitute::EndlineCallbackFunc endlineCallback, bool manualExecution = false
-	)
-	{
-		sSub.SetEndlineCallback(key, endlineCallback, manualExecution);
-	}
-
-	void RemoveEndlineCallback(const std::string& key)
-	{
-		sSub.RemoveEndlineCallback(key);
-	}
-
-	void ExecuteManualCallbacks()
-	{
-		sSub.ExecuteCallbacks(true);
-	}
 private:
 	StreambufSubstitute sSub;
 	std::unique_ptr<std::ostream> ostream;
-};
\ No newline at end of file
+};
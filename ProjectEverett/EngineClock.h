@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+/*
+	Time of the engine, advanced once per simulation frame by the time passed since the previous one.
+	Subsystems read it instead of sampling system clocks, so everything within a frame sees the same time.
+	Frames are timed by a monotonic clock, so time also passes while no frames are rendered in on demand mode.
+	Headless runs with a fixed delta time advance by the reported time of rendered frames instead
+	Game time follows the time scale and stands still while paused, real time always runs
+*/
+class EngineClock
+{
+public:
+	// Same time point as saved by SimSerializer, clock starts at the current system time
+	using TimePoint = std::chrono::system_clock::time_point;
+	using Duration = TimePoint::duration;
+
+private:
+	static inline const TimePoint startTime = std::chrono::system_clock::now();
+
+	static inline std::atomic<bool> useFrameTime = false;
+	static inline std::atomic<float> pendingFrameTime = 0.0f;
+	static inline std::chrono::steady_clock::time_point lastTickTime; // Simulation thread only
+
+	static inline std::atomic<Duration::rep> gameTime = 0;
+	static inline std::atomic<Duration::rep> realTime = 0;
+	static inline std::atomic<float> gameDeltaTime = 0.0f;
+	static inline std::atomic<float> realDeltaTime = 0.0f;
+	static inline std::atomic<size_t> frameIndex = 0;
+
+	static inline std::atomic<float> timeScale = 1.0f;
+	static inline std::atomic<bool> paused = false;
+	static inline std::atomic<float> pendingStepTime = -1.0f; // Negative if no step is requested
+
+	static Duration ToDuration(float seconds)
+	{
+		return std::chrono::duration_cast<Duration>(std::chrono::duration<float>(seconds));
+	}
+
+public:
+	// Frames are timed by the time reported through AddFrameTime instead of the monotonic clock
+	static void UseFrameTime(bool value = true)
+	{
+		useFrameTime = value;
+		pendingFrameTime = 0.0f;
+	}
+
+	// Any thread, time of a rendered frame. Frames not ticked yet add up
+	static void AddFrameTime(float seconds)
+	{
+		float current = pendingFrameTime.load(std::memory_order_relaxed);
+
+		while (!pendingFrameTime.compare_exchange_weak(current, current + std::max(seconds, 0.0f)));
+	}
+
+	// Simulation thread only, once per simulation frame before anything reads the time
+	static void Tick()
+	{
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		const float clockTime = lastTickTime == std::chrono::steady_clock::time_point() ?
+			0.0f : std::chrono::duration<float>(now - lastTickTime).count();
+		lastTickTime = now;
+
+		const float reportedTime = pendingFrameTime.exchange(0.0f);
+		const float frameTime = useFrameTime ? reportedTime : clockTime;
+		float gameFrameTime = frameTime * timeScale;
+
+		if (paused)
+		{
+			gameFrameTime = 0.0f;
+
+			// Step by the frame time waits for a frame which actually took time
+			float stepTime = pendingStepTime.load();
+
+			if (stepTime >= 0.0f && (stepTime > 0.0f || frameTime > 0.0f) &&
+				pendingStepTime.compare_exchange_strong(stepTime, -1.0f))
+			{
+				gameFrameTime = stepTime > 0.0f ? stepTime : frameTime;
+			}
+		}
+
+		realTime += ToDuration(frameTime).count();
+		gameTime += ToDuration(gameFrameTime).count();
+		realDeltaTime = frameTime;
+		gameDeltaTime = gameFrameTime;
+		++frameIndex;
+	}
+
+	static TimePoint GetTime()
+	{
+		return startTime + Duration(gameTime.load());
+	}
+
+	static TimePoint GetRealTime()
+	{
+		return startTime + Duration(realTime.load());
+	}
+
+	// Game time of the current simulation frame in seconds
+	static float GetDeltaTime()
+	{
+		return gameDeltaTime;
+	}
+
+	static float GetRealDeltaTime()
+	{
+		return realDeltaTime;
+	}
+
+	static size_t GetFrameIndex()
+	{
+		return frameIndex;
+	}
+
+	static void SetTimeScale(float scale)
+	{
+		timeScale = std::max(scale, 0.0f);
+	}
+
+	static float GetTimeScale()
+	{
+		return timeScale;
+	}
+
+	static void Pause(bool value = true)
+	{
+		paused = value;
+		pendingStepTime = -1.0f;
+	}
+
+	static bool IsPaused()
+	{
+		return paused;
+	}
+
+	// While paused, advances game time of the next frame by 'seconds', or by the real time of the frame if 0
+	static void Step(float seconds = 0.0f)
+	{
+		if (paused)
+		{
+			pendingStepTime = std::max(seconds, 0.0f);
+		}
+	}
+};
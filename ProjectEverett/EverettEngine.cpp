@@ -24,6 +24,7 @@
 
 #include "AnimSystem.h"
 
+#include "LogSystem.h"
 #include "CustomOutput.h"
 #include "RenderLogger.h"
 
@@ -39,6 +40,10 @@
 
 #include "NameTracker.h"
 #include "TimerManager.h"
+#include "EngineClock.h"
+#include "JobSystem.h"
+#include "SceneSnapshot.h"
+#include "TripleBuffer.h"
 
 using namespace EverettStructs;
 
@@ -59,6 +64,9 @@ using namespace EverettStructs;
 #define ENABLE_VSYNC true
 #endif // OPTIMIZATION_TEST
 
+// NULL_RENDER_TEST - null rendering backend by default, see EnableNullRenderBackend
+//#define NULL_RENDER_TEST
+
 
 using ObjectInfoNames = SimSerializer::ObjectInfoNames;
 
@@ -122,16 +130,37 @@ std::vector<EverettEngine::ObjectTypeInfo> EverettEngine::objectTypes
 
 #undef ToStr
 
+#ifdef NULL_RENDER_TEST
+bool EverettEngine::nullRenderBackend = true;
+#else
+bool EverettEngine::nullRenderBackend = false;
+#endif
+
+void EverettEngine::EnableNullRenderBackend(bool value)
+{
+	nullRenderBackend = value;
+}
+
 EverettEngine::EverettEngine()
 {
-	logOutput = std::make_unique<CustomOutput>();
-	errorOutput = std::make_unique<CustomOutput>();
+	logSystem = std::make_unique<LogSystem>();
+	logOutput = std::make_unique<CustomOutput>(*logSystem, LogSystem::Level::Info);
+	errorOutput = std::make_unique<CustomOutput>(*logSystem, LogSystem::Level::Error);
+	debugOutput = std::make_unique<CustomOutput>(*logSystem, LogSystem::Level::Debug);
 	stdOutStreamBuffer = std::cout.rdbuf();
 	stdErrStreamBuffer = std::cerr.rdbuf();
+	stdLogStreamBuffer = std::clog.rdbuf();
 
 	SetLogCallback();
 	
-	LGL::InitOpenGL(3, 3);
+	if (nullRenderBackend)
+	{
+		LGL::InitNullBackend();
+	}
+	else
+	{
+		LGL::InitOpenGL(3, 3);
+	}
 	SoundSim::InitOpenAL();
 
 	mainLGL    = std::make_unique<LGL>();
@@ -141,6 +170,12 @@ EverettEngine::EverettEngine()
 	hwndHolder = std::make_unique<WindowHandleHolder>();
 
 	timerManager = std::make_unique<TimerManager>();
+	jobSystem    = std::make_unique<JobSystem>();
+
+	fileLoader->modelLoader.SetJobSystem(jobSystem.get());
+
+	snapshotBuffer = std::make_unique<TripleBuffer<SceneSnapshot>>();
+	renderSnapshot = &snapshotBuffer->GetReadBuffer();
 
 	allNameTracker = std::make_unique<NameTracker>();
 		
@@ -170,6 +205,106 @@ void EverettEngine::CreateAndSetupMainWindow(
 	hwndHolder->AddCurrentWindowHandle("LGL");
 
 	mainLGL->SetAssetOnOpenGLFailure(true);
+	cmdHandler->AddCommandLambda("checkGLErrors", [this](const std::string&)
+	{
+		mainLGL->CheckGLErrors();
+		std::cout << "OpenGL errors reported so far: " << mainLGL->GetGLErrorCount() << '\n';
+	});
+	cmdHandler->AddCommandLambda("nullRenderStats", [this](const std::string&)
+	{
+		if (!LGL::IsNullBackend())
+		{
+			std::cout << "Null rendering backend is not active\n";
+			return;
+		}
+
+		LGL::NullBackendStats stats = mainLGL->GetNullBackendStats();
+		std::cout << "GL calls since the last reset - draws: " << stats.drawCalls 
+			<< ", uniform uploads: " << stats.uniformUploads << ", binds: " << stats.binds 
+			<< ", total: " << stats.totalCalls << '\n';
+
+		mainLGL->ResetNullBackendStats();
+	});
+	cmdHandler->AddCommandLambda("fenceWaitTime", [this](const std::string&)
+	{
+		std::cout << "Render thread waited for the GPU " << mainLGL->GetLastFenceWaitTime() 
+			<< " ms last frame, " << mainLGL->GetAverageFenceWaitTime() << " ms per frame on average\n";
+	});
+	cmdHandler->AddCommandLambda("contextLockStats", [this](const std::string&)
+	{
+		LGL::ContextLockStats stats = mainLGL->GetContextLockStats();
+		std::cout << "Render context locks since the last reset - taken: " << stats.acquisitions 
+			<< ", contended: " << stats.contendedAcquisitions << ", nested: " << stats.reentries 
+			<< ", wait: " << stats.totalWaitMs << " ms (max " << stats.maxWaitMs << " ms)"
+			<< ", hold: " << stats.totalHoldMs << " ms (max " << stats.maxHoldMs << " ms)\n";
+
+		mainLGL->ResetContextLockStats();
+	});
+	cmdHandler->AddCommandLambda("logLevel", [this](const std::string& arg)
+	{
+		SetLogLevel(arg.empty() ? 1 : std::stoi(arg));
+	});
+	cmdHandler->AddCommandLambda("timeScale", [this](const std::string& arg)
+	{
+		if (arg.empty())
+		{
+			std::cout << "Time scale: " << GetTimeScale() << '\n';
+			return;
+		}
+
+		SetTimeScale(std::stof(arg));
+	});
+	cmdHandler->AddCommandLambda("pauseTime", [this](const std::string&)
+	{
+		PauseTime(!IsTimePaused());
+	});
+	cmdHandler->AddCommandLambda("stepTime", [this](const std::string&)
+	{
+		StepTime();
+	});
+	cmdHandler->AddCommandLambda("jobBenchmark", [this](const std::string& arg)
+	{
+		const size_t itemAmount = arg.empty() ? 1000000 : std::stoull(arg);
+		std::vector<float> items(itemAmount, 1.0f);
+
+		auto workload = [&items](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				items[i] = std::sqrt(items[i] + std::sin(static_cast<float>(i)));
+			}
+		};
+
+		auto measure = [](auto&& func)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			func();
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		const float serialTime = measure([&]() { workload(0, itemAmount); });
+		const float parallelTime = measure([&]() { jobSystem->ParallelFor(itemAmount, workload, 1024); });
+
+		std::cout << itemAmount << " items - serial: " << serialTime << " ms, parallel on " 
+			<< jobSystem->GetWorkerAmount() + 1 << " threads: " << parallelTime << " ms\n";
+	});
+	cmdHandler->AddCommandLambda("screenshot", [this](const std::string& path)
+	{
+		mainLGL->StartFrameCapture(path.empty() ? "screenshot" : path, LGL::CaptureFormat::PNG, 1);
+	});
+	cmdHandler->AddCommandLambda("recordFrames", [this](const std::string& path)
+	{
+		// Without a path stops the recording
+		if (path.empty())
+		{
+			mainLGL->StopFrameCapture();
+			std::cout << "Frames written: " << mainLGL->GetCapturedFrameCount() 
+				<< ", dropped: " << mainLGL->GetDroppedCaptureFrameCount() << '\n';
+			return;
+		}
+
+		mainLGL->StartFrameCapture(path, LGL::CaptureFormat::Raw);
+	});
 	mainLGL->SetShaderFolder(FileLoader::GetCurrentDir() + '\\' + shaderPath);
 
 	if (enableLogger)
@@ -200,7 +335,7 @@ void EverettEngine::CreateAndSetupMainWindow(
 			[this]() { generalRenderTextBehaviour(ColorManager::GetColorVec4(ColorManager::Colors::WHITE)); },
 			[this]() { generalRenderTextBehaviour(ColorManager::GetColorVec4(ColorManager::Colors::RED)); },
 			[this](const std::string& labelName, LGLStructs::TextInfo& text) { mainLGL->CreateText(labelName, text); },
-			[this](const std::string& labelName) { mainLGL->DeleteText(labelName); }
+			[this]() { mainLGL->RequestRedraw(); }
 		);
 
 		fileLoader->fontLoader.FreeFaceInfoByFont(loggerFont, true);
@@ -212,7 +347,7 @@ void EverettEngine::CreateAndSetupMainWindow(
 	camera->SetMode(CameraSim::Mode::Fly);
 
 	mainLGL->SetFramebufferSizeCallback([this](int width, int height) { 
-		camera->SetAspect(width, height);
+		RunOnSimulationThread([this, width, height]() { camera->SetAspect(width, height); });
 
 		if (logger)
 		{
@@ -226,13 +361,18 @@ void EverettEngine::CreateAndSetupMainWindow(
 
 	mainLGL->SetCursorPositionCallback(
 		[this](double xpos, double ypos) {
-			camera->RotateByMousePos(static_cast<float>(xpos), static_cast<float>(ypos));
-			ExecuteVectorOfFuncs(mouseMoveScriptFuncs, xpos, ypos); 
+			RunOnSimulationThread([this, xpos, ypos]() {
+				camera->RotateByMousePos(static_cast<float>(xpos), static_cast<float>(ypos));
+				ExecuteVectorOfFuncs(mouseMoveScriptFuncs, xpos, ypos);
+			});
 		}
 	);
-	mainLGL->SetScrollCallback([this](double xpos, double ypos) { ExecuteVectorOfFuncs(mouseScrollScriptFuncs, ypos); });
+	mainLGL->SetScrollCallback([this](double xpos, double ypos) { 
+		RunOnSimulationThread([this, ypos]() { ExecuteVectorOfFuncs(mouseScrollScriptFuncs, ypos); });
+	});
 
-	mainLGL->SetRenderDeltaCallback(ObjectSim::SetRenderDeltaTime);
+	// Only used by the clock in headless runs with a fixed delta time
+	mainLGL->SetRenderDeltaCallback(&EngineClock::AddFrameTime);
 
 	mainLGL->GetMaxAmountOfVertexAttr();
 	mainLGL->CaptureMouse(true);
@@ -264,6 +404,7 @@ void EverettEngine::CreateAndSetupMainWindow(
 	mainLGL->EnableVSync(ENABLE_VSYNC);
 	mainLGL->EnableUniformValueBatchSending(ENABLE_OPTIMIZATIONS);
 	mainLGL->EnableUniformValueHashing(ENABLE_OPTIMIZATIONS);
+	mainLGL->EnableAsyncTextureUpload(ENABLE_OPTIMIZATIONS);
 }
 
 void EverettEngine::SetDebugLogVisible(bool value)
@@ -303,6 +444,121 @@ void EverettEngine::SetDefaultWASDControls(bool value)
 	}
 }
 
+void EverettEngine::EnableDynamicResolution(bool value, float targetFrameTimeMs)
+{
+	mainLGL->EnableDynamicResolution(value, targetFrameTimeMs);
+}
+
+void EverettEngine::SetFramesInFlight(size_t amount)
+{
+	mainLGL->SetFramesInFlight(amount);
+}
+
+void EverettEngine::SetJobWorkerAmount(size_t amount)
+{
+	jobSystem->SetWorkerAmount(amount);
+
+	std::cout << "Job worker amount has been set to " << amount << '\n';
+}
+
+size_t EverettEngine::GetJobWorkerAmount()
+{
+	return jobSystem->GetWorkerAmount();
+}
+
+void EverettEngine::ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func, size_t minBatchSize)
+{
+	jobSystem->ParallelFor(count, func, minBatchSize);
+}
+
+void EverettEngine::EnableTextureStreaming(bool value, size_t vramBudgetMB)
+{
+	textureStreamingEnabled = value;
+	mainLGL->EnableTextureStreaming(value, vramBudgetMB * 1024 * 1024);
+}
+
+void EverettEngine::EnableSharedContextUpload(bool value)
+{
+	mainLGL->EnableSharedContextUpload(value);
+}
+
+void EverettEngine::EnableHeadlessMode(size_t frameCount, float fixedDeltaTime, bool readbackLastFrame)
+{
+	mainLGL->EnableHeadlessMode(true, frameCount, fixedDeltaTime, readbackLastFrame);
+
+	// Runs with a fixed delta time are reproducible, independent of how long frames actually took
+	EngineClock::UseFrameTime(mainLGL->IsHeadless() && fixedDeltaTime > 0.0f);
+}
+
+bool EverettEngine::SaveLastFrame(const std::string& path)
+{
+	return mainLGL->SaveLastFrame(path);
+}
+
+void EverettEngine::SetModelResidencyPolicy(float idleSeconds, size_t vramBudgetMB)
+{
+	modelEvictionIdleTime = idleSeconds;
+	modelVRAMBudget = vramBudgetMB * 1024 * 1024;
+}
+
+void EverettEngine::EnableOnDemandRendering(bool value)
+{
+	onDemandRenderingEnabled = value;
+
+	// Any change of a sim object's transform, from scripts, the editor or the engine itself, redraws the frame
+	ValueObserverNotifier::SetValueChangeCallback(value ? [this]() { mainLGL->RequestRedraw(); } : std::function<void()>());
+	mainLGL->EnableOnDemandRendering(value);
+}
+
+void EverettEngine::RequestRedraw()
+{
+	mainLGL->RequestRedraw();
+}
+
+bool EverettEngine::IsPlaybackActive()
+{
+	if (SoundSim::IsAnySoundPlaying())
+	{
+		return true;
+	}
+
+	return std::any_of(solids.begin(), solids.end(), [](auto& solid) { return solid.second.IsModelAnimationPlaying(); });
+}
+
+void EverettEngine::UpdateAllTransforms()
+{
+	// Gathered every frame, the list never holds sims deleted since the last one
+	transformUpdateList.clear();
+
+	if (camera)
+	{
+		transformUpdateList.push_back(camera.get());
+	}
+
+	auto addSims = [this](auto& container)
+	{
+		for (auto& [_, sim] : container)
+		{
+			transformUpdateList.push_back(&sim);
+		}
+	};
+
+	addSims(solids);
+	addSims(lights);
+	addSims(sounds);
+	addSims(colliders);
+
+	// Matrices are recomputed in parallel, callbacks (OpenAL updates, redraw requests) are executed in order afterwards
+	jobSystem->ParallelFor(
+		std::span<ObjectSim*>(transformUpdateList), [](ObjectSim* sim) { sim->ApplyTransformChanges(); }, 256
+	);
+
+	for (ObjectSim* sim : transformUpdateList)
+	{
+		sim->FlushTransformCallbacks();
+	}
+}
+
 void EverettEngine::EnableGizmoCreation()
 {
 	gizmoEnabled = true;
@@ -366,6 +622,8 @@ void EverettEngine::AddInteractable(
 	std::function<void()> releaseFunc
 )
 {
+	auto simLock = LockSimulation();
+
 	AddInteractableImpl(key, holdable, std::move(pressFunc), std::move(releaseFunc), false);
 }
 
@@ -395,24 +653,37 @@ void EverettEngine::AddInteractableImpl(
 	{
 		mainLGL->SetInteractable(
 			key, true,
-			[this, key]() { keyScriptFuncMap[key].ButtonPressed();  },
-			[this, key]() { keyScriptFuncMap[key].ButtonReleased(); }
+			[this, key]() { RunOnSimulationThread([this, key]() { keyScriptFuncMap[key].ButtonPressed();  }); },
+			[this, key]() { RunOnSimulationThread([this, key]() { keyScriptFuncMap[key].ButtonReleased(); }); }
 		);
 	}
 }
 
-void EverettEngine::AddTimedCallback(TimedCallbackSetup timedCallbackSetup)
+IEverettEngine::TimedCallbackHandle EverettEngine::AddTimedCallback(TimedCallbackSetup timedCallbackSetup)
 {
-	timerManager->AddTimedCallback(std::move(timedCallbackSetup));
+	auto simLock = LockSimulation();
+
+	return timerManager->AddTimedCallback(std::move(timedCallbackSetup));
+}
+
+bool EverettEngine::CancelTimedCallback(TimedCallbackHandle handle)
+{
+	auto simLock = LockSimulation();
+
+	return timerManager->CancelTimedCallback(handle);
 }
 
 void EverettEngine::AddMouseScrollCallback(std::function<void(double)> callback)
 {
+	auto simLock = LockSimulation();
+
 	mouseScrollScriptFuncs.push_back(std::move(callback));
 }
 
 void EverettEngine::AddMouseMoveCallback(std::function<void(double, double)> callback)
 {
+	auto simLock = LockSimulation();
+
 	mouseMoveScriptFuncs.push_back(std::move(callback));
 }
 
@@ -431,37 +702,384 @@ void EverettEngine::ClearExternallyControlledContainers()
 
 void EverettEngine::RunRenderWindow()
 {
+	if (simulationThreadEnabled)
+	{
+		simulationRunning = true;
+		simulationThread = std::thread(&EverettEngine::SimulationLoop, this);
+	}
+
 	auto additionalFuncs = [this]() {
-		currentStartSolidIndex = 0;
-		nextStartSolidIndex = 0;
+		if (!simulationThreadEnabled)
+		{
+			SimulationStep();
+		}
 
-		CheckAndLoadRequestedWorld();
+		ApplySnapshot();
 
-		timerManager->ProcessTimedCallbacks();
+		logSystem->ExecuteManualSinks();
 
-		ColliderSim::ExecuteBroadCollisionCheck();
+		if (logger)
+		{
+			logger->Update();
+		}
+	};
 
-		ExecuteFuncForAllSimObjects(&ObjectSim::UpdateTransform);
+	mainLGL->RunRenderingCycle(additionalFuncs);
 
-		std::vector<glm::mat4>& finalTransforms = animSystem->GetFinalTransforms();
+	if (simulationThread.joinable())
+	{
+		simulationRunning = false;
 
-		if (!finalTransforms.empty())
 		{
-			mainLGL->SetShaderUniformValue("Bones", finalTransforms, defaultShaderProgram);
+			std::lock_guard<std::mutex> lock(snapshotMux);
 		}
+		snapshotConsumedCondVar.notify_one();
+
+		simulationThread.join();
+	}
+}
+
+void EverettEngine::EnableSimulationThread(bool value)
+{
+	if (simulationRunning)
+	{
+		std::cerr << "Simulation thread cannot be changed while rendering\n";
+		return;
+	}
+
+	simulationThreadEnabled = value;
+
+	std::cout << "Simulation thread has been set to " << value << '\n';
+}
+
+// Empty lock without the simulation thread, scene is then changed between frames under the render handshake as before
+std::unique_lock<std::recursive_mutex> EverettEngine::LockSimulation()
+{
+	return simulationRunning ? 
+		std::unique_lock<std::recursive_mutex>(simulationMux) : std::unique_lock<std::recursive_mutex>();
+}
 
-		if (models.size())
+void EverettEngine::RunOnSimulationThread(std::function<void()> func)
+{
+	if (!simulationRunning)
+	{
+		func();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(simulationCommandMux);
+	simulationCommands.push_back(std::move(func));
+}
+
+void EverettEngine::ExecuteSimulationCommands()
+{
+	std::vector<std::function<void()>> commands;
+
+	{
+		std::lock_guard<std::mutex> lock(simulationCommandMux);
+		commands.swap(simulationCommands);
+	}
+
+	for (auto& command : commands)
+	{
+		command();
+	}
+}
+
+void EverettEngine::SimulationLoop()
+{
+	while (simulationRunning)
+	{
 		{
-			LightUpdater();
+			// Stepping further ahead of the render thread would only produce snapshots nobody sees
+			std::unique_lock<std::mutex> lock(snapshotMux);
+			snapshotConsumedCondVar.wait_for(
+				lock, simulationIdleTick, [this]() { return !snapshotBuffer->HasUnconsumed() || !simulationRunning; }
+			);
 		}
 
-		logOutput->ExecuteManualCallbacks();
-		errorOutput->ExecuteManualCallbacks();
+		if (!simulationRunning)
+		{
+			break;
+		}
 
-		fileLoader->dllLoader.ExecuteAllMainScriptFuncs();
-	};
+		std::lock_guard<std::recursive_mutex> lock(simulationMux);
+		SimulationStep();
+	}
+}
 
-	mainLGL->RunRenderingCycle(additionalFuncs);
+void EverettEngine::SimulationStep()
+{
+	ExecuteSimulationCommands();
+
+	CheckAndLoadRequestedWorld();
+
+	EngineClock::Tick();
+	const float frameDeltaTime = EngineClock::GetDeltaTime();
+
+	bool timerFired = false;
+
+	if (fixedStepTime > 0.0f)
+	{
+		const float stepTime = fixedStepTime;
+		stepAccumulator += frameDeltaTime;
+
+		size_t stepAmount = static_cast<size_t>(stepAccumulator / stepTime);
+
+		// Time of frames too slow to keep up with is dropped, the simulation slows down instead of spiralling
+		if (stepAmount > maxStepsPerFrame)
+		{
+			stepAmount = maxStepsPerFrame;
+			stepAccumulator = std::fmod(stepAccumulator, stepTime);
+		}
+		else
+		{
+			stepAccumulator -= stepAmount * stepTime;
+		}
+
+		ObjectSim::SetRenderDeltaTime(stepTime);
+
+		for (size_t step = 0; step < stepAmount; ++step)
+		{
+			if (step + 1 == stepAmount)
+			{
+				StorePreviousTransforms();
+			}
+
+			timerFired |= SimulationTick(stepTime);
+		}
+
+		// Input between steps moves objects by the frame time, its changes are applied by the next step.
+		// Frames between steps only blend the last two step transforms in the snapshot
+		ObjectSim::SetRenderDeltaTime(frameDeltaTime);
+
+		interpolationAlpha = std::clamp(stepAccumulator / stepTime, 0.0f, 1.0f);
+	}
+	else
+	{
+		ObjectSim::SetRenderDeltaTime(frameDeltaTime);
+		timerFired = SimulationTick(frameDeltaTime);
+	}
+
+	ProcessAllAnimations();
+
+	// Changes of sim objects and input request redraws on their own
+	if (onDemandRenderingEnabled && (timerFired || IsPlaybackActive()))
+	{
+		mainLGL->RequestRedraw();
+	}
+
+	WriteSnapshot(snapshotBuffer->GetWriteBuffer());
+	snapshotBuffer->Publish();
+}
+
+bool EverettEngine::SimulationTick(float tickTime)
+{
+	const bool timerFired = timerManager->ProcessTimedCallbacks(tickTime);
+
+	ColliderSim::ExecuteBroadCollisionCheck();
+
+	UpdateAllTransforms();
+
+	fileLoader->dllLoader.ExecuteAllMainScriptFuncs();
+
+	return timerFired;
+}
+
+void EverettEngine::StorePreviousTransforms()
+{
+	for (auto& [_, solid] : solids)
+	{
+		solid.StorePreviousTransform();
+	}
+}
+
+void EverettEngine::SetFixedSimulationRate(float stepsPerSecond, size_t maxStepsPerFrame)
+{
+	auto simLock = LockSimulation();
+
+	this->maxStepsPerFrame = std::max<size_t>(maxStepsPerFrame, 1);
+	stepAccumulator = 0.0f;
+	fixedStepTime = stepsPerSecond > 0.0f ? 1.0f / stepsPerSecond : 0.0f;
+
+	StorePreviousTransforms();
+
+	std::cout << "Fixed simulation rate has been set to " << std::max(stepsPerSecond, 0.0f) << " steps per second\n";
+}
+
+void EverettEngine::SetTimeScale(float scale)
+{
+	EngineClock::SetTimeScale(scale);
+
+	std::cout << "Time scale has been set to " << EngineClock::GetTimeScale() << '\n';
+}
+
+float EverettEngine::GetTimeScale()
+{
+	return EngineClock::GetTimeScale();
+}
+
+void EverettEngine::PauseTime(bool value)
+{
+	EngineClock::Pause(value);
+
+	std::cout << "Time has been " << (value ? "paused" : "resumed") << '\n';
+}
+
+bool EverettEngine::IsTimePaused()
+{
+	return EngineClock::IsPaused();
+}
+
+void EverettEngine::StepTime()
+{
+	EngineClock::Step(fixedStepTime);
+
+	// Step by the frame time needs a frame to be rendered
+	mainLGL->RequestRedraw();
+}
+
+void EverettEngine::ProcessAllAnimations()
+{
+	for (auto& [_, model] : models)
+	{
+		auto modelPtr = model.GetFullModelInfo().first.lock();
+		auto modelAnimPtr = model.GetFullModelInfo().second.lock();
+
+		if (!modelPtr || !modelPtr->render || !modelAnimPtr || modelAnimPtr->animInfoVect.empty()) continue;
+
+		for (auto& solidPtr : model.GetRelatedSolids())
+		{
+			animSystem->ProcessAnimations(*modelAnimPtr, *solidPtr);
+		}
+	}
+}
+
+// Buffer is reused, containers are refilled keeping their capacity
+void EverettEngine::WriteSnapshot(SceneSnapshot& snapshot)
+{
+	snapshot.snapshotIndex = ++snapshotIndex;
+
+	snapshot.proj = camera->GetProjectionMatrixAddr();
+	snapshot.view = camera->GetViewMatrixAddr();
+	snapshot.viewPos = camera->GetPositionVectorAddr();
+	snapshot.ambient = LightSim::SGetAmbientLightColorVectorAddr();
+	snapshot.interpolated = fixedStepTime > 0.0f;
+	snapshot.interpolationAlpha = interpolationAlpha;
+
+	for (size_t i = 0; i < snapshot.lightAmounts.size(); ++i)
+	{
+		snapshot.lightAmounts[i] = static_cast<int>(LightSim::GetAmountOfLightsByType(static_cast<LightSim::LightTypes>(i)));
+	}
+
+	snapshot.lights.clear();
+
+	for (auto& [_, light] : lights)
+	{
+		snapshot.lights.push_back({ 
+			light.GetLightType(), light.GetPositionVectorAddr(), light.GetFrontVector(), 
+			light.GetColorVectorAddr(), light.GetAttenuation() 
+		});
+	}
+
+	snapshot.bones = animSystem->GetFinalTransforms();
+
+	for (auto& [_, model] : models)
+	{
+		SceneSnapshot::ModelEntry& entry = snapshot.models[&model];
+		entry.snapshotIndex = snapshot.snapshotIndex;
+		entry.meshAmount = 0;
+		entry.solids.clear();
+		entry.meshVisibility.clear();
+		entry.meshShininess.clear();
+
+		for (auto& solidPtr : model.GetRelatedSolids())
+		{
+			SolidSim& solid = *solidPtr;
+
+			entry.meshAmount = solid.GetMeshAmount();
+			entry.solids.push_back({
+				solid.GetModelVisibility(),
+				solid.GetModelMatrixAddr(),
+				solid.GetInverseModelMatrix(),
+				solid.GetModelAnimationAmount() ? static_cast<int>(solid.GetModelCurrentStartingBoneIndex()) : -1,
+				solid.GetModelDefaultColor()
+			});
+
+			if (snapshot.interpolated)
+			{
+				SceneSnapshot::SolidEntry& solidEntry = entry.solids.back();
+				SceneSnapshot::Transform& previous = solidEntry.previous;
+
+				solidEntry.moved = solid.GetPreviousTransform(previous.pos, previous.orient, previous.scale);
+				solidEntry.current = { solid.GetPositionVectorAddr(), solid.GetOrientationAddr(), solid.GetScaleVectorAddr() };
+			}
+
+			for (size_t meshIndex = 0; meshIndex < entry.meshAmount; ++meshIndex)
+			{
+				entry.meshVisibility.push_back(solid.GetModelMeshVisibility(meshIndex));
+				entry.meshShininess.push_back(solid.GetModelMeshShininess(meshIndex));
+			}
+		}
+	}
+
+	std::erase_if(snapshot.models, [&snapshot](const auto& entry) { return entry.second.snapshotIndex != snapshot.snapshotIndex; });
+
+	snapshot.modelScreenSizes.clear();
+
+	if (textureStreamingEnabled)
+	{
+		UpdateModelScreenSizes(snapshot);
+	}
+
+	snapshot.unusedModels.clear();
+
+	for (auto& [modelName, model] : models)
+	{
+		if (model.GetRelatedSolids().empty())
+		{
+			snapshot.unusedModels.push_back({ modelName, model.GetUnusedTime() });
+		}
+	}
+}
+
+// Render thread only, never waits for the simulation
+void EverettEngine::ApplySnapshot()
+{
+	if (snapshotBuffer->Consume() && simulationRunning)
+	{
+		{
+			std::lock_guard<std::mutex> lock(snapshotMux);
+		}
+		snapshotConsumedCondVar.notify_one();
+	}
+
+	renderSnapshot = &snapshotBuffer->GetReadBuffer();
+
+	currentStartSolidIndex = 0;
+	nextStartSolidIndex = 0;
+
+	if (!renderSnapshot->snapshotIndex)
+	{
+		return;
+	}
+
+	if (!renderSnapshot->bones.empty())
+	{
+		mainLGL->SetShaderUniformValue("Bones", renderSnapshot->bones, defaultShaderProgram);
+	}
+
+	if (!renderSnapshot->models.empty())
+	{
+		LightUpdater(*renderSnapshot);
+
+		for (auto& [modelName, screenSize] : renderSnapshot->modelScreenSizes)
+		{
+			mainLGL->SetModelScreenSize(modelName, screenSize);
+		}
+
+		UpdateModelResidency(*renderSnapshot);
+	}
 }
 
 void EverettEngine::StopRenderWindow()
@@ -501,6 +1119,8 @@ int EverettEngine::ConvertKeyTo(const char* keyName)
 
 bool EverettEngine::CreateModel(const std::string& path, const std::string& name)
 {
+	auto simLock = LockSimulation();
+
 	return CreateModelImpl(path, name, !models.size());
 }
 
@@ -536,36 +1156,37 @@ bool EverettEngine::CreateModelImpl(const std::string& path, const std::string&
 		mainLGL->SetShaderUniformValue("textureless", static_cast<int>(modelPtr->isTextureless));
 		mainLGL->SetShaderUniformValue("animationless", static_cast<int>(animationless));
 
-		if (!animationless)
-		{
-			for (auto& solidPtr : model.GetRelatedSolids())
-			{
-				animSystem->ProcessAnimations(*modelAnimPtr, *solidPtr);
-			}
-		}
+		// Solids are drawn as of the last snapshot, animations are already processed by the simulation
+		auto entryIter = renderSnapshot->models.find(&model);
 
-		if (!model.GetRelatedSolids().empty())
+		if (entryIter != renderSnapshot->models.end() && !entryIter->second.solids.empty())
 		{
 			size_t index = currentStartSolidIndex = nextStartSolidIndex;
-			for (auto& solidPtr : model.GetRelatedSolids())
+			for (auto& solid : entryIter->second.solids)
 			{
-				SolidSim& solid = *solidPtr;
-
-				if (solid.GetModelVisibility())
+				if (solid.visible)
 				{
-					LGLUtils::SetShaderUniformArrayAt(*mainLGL, "models", index, solid.GetModelMatrixAddr());
-					LGLUtils::SetShaderUniformArrayAt(*mainLGL, "invs", index, solid.GetInverseModelMatrix());
+					if (renderSnapshot->interpolated && solid.moved)
+					{
+						const glm::mat4 interpolatedModel = solid.GetInterpolatedModel(renderSnapshot->interpolationAlpha);
+
+						LGLUtils::SetShaderUniformArrayAt(*mainLGL, "models", index, interpolatedModel);
+						LGLUtils::SetShaderUniformArrayAt(*mainLGL, "invs", index, glm::inverse(interpolatedModel));
+					}
+					else
+					{
+						LGLUtils::SetShaderUniformArrayAt(*mainLGL, "models", index, solid.model);
+						LGLUtils::SetShaderUniformArrayAt(*mainLGL, "invs", index, solid.inverseModel);
+					}
 
-					if (solid.GetModelAnimationAmount())
+					if (solid.startingBoneIndex >= 0)
 					{
-						LGLUtils::SetShaderUniformArrayAt(
-							*mainLGL, "startingBoneIndexes", index, static_cast<int>(solid.GetModelCurrentStartingBoneIndex())
-						);
+						LGLUtils::SetShaderUniformArrayAt(*mainLGL, "startingBoneIndexes", index, solid.startingBoneIndex);
 					}
 
 					if (modelPtr->isTextureless)
 					{
-						LGLUtils::SetShaderUniformArrayAt(*mainLGL, "defaultColors", index, solid.GetModelDefaultColor());
+						LGLUtils::SetShaderUniformArrayAt(*mainLGL, "defaultColors", index, solid.defaultColor);
 					}
 				}
 
@@ -578,18 +1199,27 @@ bool EverettEngine::CreateModelImpl(const std::string& path, const std::string&
 	modelSolidInfo.SetGeneralMeshBehaviour([this](const ModelInfo& model, int meshIndex)
 	{
 		// Existence of the lambda implies existence of the model
+		auto entryIter = renderSnapshot->models.find(&model);
+
+		if (entryIter == renderSnapshot->models.end() || static_cast<size_t>(meshIndex) >= entryIter->second.meshAmount)
+		{
+			return;
+		}
+
+		const SceneSnapshot::ModelEntry& entry = entryIter->second;
+
 		size_t index = currentStartSolidIndex;
-		for (auto& solidPtr : model.GetRelatedSolids())
+		for (size_t solidIndex = 0; solidIndex < entry.solids.size(); ++solidIndex)
 		{
-			SolidSim& solid = *solidPtr;
+			const size_t meshValueIndex = solidIndex * entry.meshAmount + meshIndex;
 
-			if (solid.GetModelVisibility())
+			// Mesh is not rendered at all if no solid has it visible, hidden ones are simply not drawn
+			if (entry.solids[solidIndex].visible && entry.meshVisibility[meshValueIndex])
 			{
 				mainLGL->SetShaderUniformValue("solidIndex", static_cast<int>(index));
-				mainLGL->SetShaderUniformValue("meshVisibility", static_cast<int>(solid.GetModelMeshVisibility(meshIndex)));
 				mainLGL->SetShaderUniformValue(
 					lightShaderValueNames[0].first + '.' + lightShaderValueNames[0].second[2],
-					solid.GetModelMeshShininess(meshIndex)
+					entry.meshShininess[meshValueIndex]
 				);
 			}
 
@@ -602,13 +1232,16 @@ bool EverettEngine::CreateModelImpl(const std::string& path, const std::string&
 		GenerateShader();
 	}
 
-	mainLGL->CreateModel(name, modelInfo);
+	// Meshes are uploaded by the render thread over the next frames, the model is not rendered before its solids anyway
+	mainLGL->CreateModelAsync(name, modelInfo);
 
 	return true;
 }
 
 bool EverettEngine::CreateSolid(const std::string& modelName, const std::string& solidName)
 {
+	auto simLock = LockSimulation();
+
 	return CreateSolidImpl(modelName, solidName, true, true);
 }
 
@@ -683,11 +1316,14 @@ void EverettEngine::GenerateShader()
 
 	shaderGen.GenerateShaderFiles(filePath);
 
-	mainLGL->RecompileShader(defaultShaderProgram);
+	// Commands are executed in order, so models created after this are rendered with the new shader
+	mainLGL->RecompileShaderAsync(defaultShaderProgram);
 }
 
 bool EverettEngine::CreateLight(const std::string& lightName, LightTypes lightType)
 {
+	auto simLock = LockSimulation();
+
 	LightSim* light = CreateLightImpl(lightName, lightType);
 	bool res = light;
 
@@ -726,6 +1362,8 @@ LightSim* EverettEngine::CreateLightImpl(const std::string& lightName, LightType
 
 bool EverettEngine::CreateSound(const std::string& path, const std::string& soundName)
 {
+	auto simLock = LockSimulation();
+
 	SoundSim* sound = CreateSoundImpl(path, soundName);
 	bool res = sound;
 
@@ -768,6 +1406,8 @@ SoundSim* EverettEngine::CreateSoundImpl(const std::string& path, const std::str
 
 bool EverettEngine::CreateCollider(const std::string& colliderName)
 {
+	auto simLock = LockSimulation();
+
 	ColliderSim* collider = CreateColliderImpl(colliderName);
 	bool res = collider;
 
@@ -833,6 +1473,7 @@ std::expected<void, std::string> EverettEngine::RenameObject(
 		return CheckNextOne;
 	};
 
+	auto simLock = LockSimulation();
 	mainLGL->PauseRendering();
 
 	// Monadic-like check
@@ -867,6 +1508,7 @@ std::expected<void, std::string> EverettEngine::DeleteObject(
 		return CheckNextOne;
 	};
 
+	auto simLock = LockSimulation();
 	mainLGL->PauseRendering();
 
 	// Monadic-like check
@@ -931,6 +1573,8 @@ EverettEngine::ObjectModificationState EverettEngine::DeleteModel(const std::str
 
 	if (iter != models.end())
 	{
+		// Not queued, waits for the frame in progress: it may still run behaviours of the model,
+		// which capture the model info erased below
 		mainLGL->DeleteModel(modelName);
 		DeleteSolidsByModel(modelName);
 	
@@ -1106,28 +1750,22 @@ ICameraSim* EverettEngine::GetCameraInterface()
 	return dynamic_cast<ICameraSim*>(GetObjectFromMap(ObjectTypes::Camera, ""));
 }
 
-void EverettEngine::LightUpdater()
+void EverettEngine::LightUpdater(const SceneSnapshot& snapshot)
 {
-	mainLGL->SetShaderUniformValue("proj", camera->GetProjectionMatrixAddr(), defaultShaderProgram);
-	mainLGL->SetShaderUniformValue("view", camera->GetViewMatrixAddr());
+	mainLGL->SetShaderUniformValue("proj", snapshot.proj, defaultShaderProgram);
+	mainLGL->SetShaderUniformValue("view", snapshot.view);
 
-	mainLGL->SetShaderUniformValue(
-		"dirLightAmount", static_cast<int>(LightSim::GetAmountOfLightsByType(LightSim::LightTypes::Direction))
-	);
-	mainLGL->SetShaderUniformValue(
-		"pointLightAmount", static_cast<int>(LightSim::GetAmountOfLightsByType(LightSim::LightTypes::Point))
-	);
-	mainLGL->SetShaderUniformValue(
-		"spotLightAmount", static_cast<int>(LightSim::GetAmountOfLightsByType(LightSim::LightTypes::Spot))
-	);
-	mainLGL->SetShaderUniformValue("ambient", LightSim::SGetAmbientLightColorVectorAddr());
+	mainLGL->SetShaderUniformValue("dirLightAmount", snapshot.lightAmounts[LightSim::LightTypes::Direction]);
+	mainLGL->SetShaderUniformValue("pointLightAmount", snapshot.lightAmounts[LightSim::LightTypes::Point]);
+	mainLGL->SetShaderUniformValue("spotLightAmount", snapshot.lightAmounts[LightSim::LightTypes::Spot]);
+	mainLGL->SetShaderUniformValue("ambient", snapshot.ambient);
 	
 	std::array<size_t, LightSim::LightTypes::_SIZE> lightCounter{0, 0, 0};
 
-	for (auto& [_, light] : lights)
+	for (auto& light : snapshot.lights)
 	{
-		LightSim::LightTypes lightType = light.GetLightType();
-		LightSim::Attenuation atten = light.GetAttenuation();
+		LightSim::LightTypes lightType = light.type;
+		const LightSim::Attenuation& atten = light.atten;
 
 		int lightIndex = static_cast<int>(lightType);
 
@@ -1142,7 +1780,7 @@ void EverettEngine::LightUpdater()
 				lightShaderValueNames[lightIndex].first,
 				lightCounter[lightIndex]++,
 				lightShaderValueNames[lightIndex].second,
-				light.GetPositionVectorAddr(), light.GetColorVectorAddr(),
+				light.pos, light.color,
 				glm::vec3(1.0f, 1.0f, 1.0f), 1.0f, atten.linear,
 				atten.quadratic
 			);
@@ -1153,8 +1791,8 @@ void EverettEngine::LightUpdater()
 				lightShaderValueNames[lightIndex].first,
 				lightCounter[lightIndex]++,
 				lightShaderValueNames[lightIndex].second,
-				light.GetPositionVectorAddr(), light.GetFrontVector(),
-				light.GetColorVectorAddr(), glm::vec3(1.0f, 1.0f, 1.0f), 1.0f,
+				light.pos, light.front,
+				light.color, glm::vec3(1.0f, 1.0f, 1.0f), 1.0f,
 				atten.linear, atten.quadratic, glm::cos(glm::radians(12.5f)),
 				glm::cos(glm::radians(17.5f))
 			);
@@ -1164,14 +1802,74 @@ void EverettEngine::LightUpdater()
 		}
 	}
 
-	mainLGL->SetShaderUniformValue("viewPos", camera->GetPositionVectorAddr());
+	mainLGL->SetShaderUniformValue("viewPos", snapshot.viewPos);
 
 	mainLGL->SetShaderUniformValue(lightShaderValueNames[0].first + '.' + lightShaderValueNames[0].second[0], 0);
 	mainLGL->SetShaderUniformValue(lightShaderValueNames[0].first + '.' + lightShaderValueNames[0].second[1], 1);
 }
 
+// Projected size of the largest visible solid of each model, drives mip streaming of the model textures
+void EverettEngine::UpdateModelScreenSizes(SceneSnapshot& snapshot)
+{
+	const glm::vec3& cameraPos = camera->GetPositionVectorAddr();
+	// Pixels covered by an object of unit size at unit distance
+	const float pixelsPerUnit = 
+		mainLGL->GetCurrentWindowHeight() / (2.0f * std::tan(glm::radians(camera->GetFOV()) / 2.0f));
+
+	for (auto& [modelName, model] : models)
+	{
+		float screenSize = 0.0f;
+
+		for (auto& solidPtr : model.GetRelatedSolids())
+		{
+			SolidSim& solid = *solidPtr;
+
+			if (!solid.GetModelVisibility()) continue;
+
+			const glm::vec3& scale = solid.GetScaleVectorAddr();
+			const float solidExtent = model.GetModelExtent() * std::max({ scale.x, scale.y, scale.z });
+			const float distance = std::max(glm::distance(cameraPos, solid.GetPositionVectorAddr()), 0.01f);
+
+			screenSize = std::max(screenSize, solidExtent / distance * pixelsPerUnit);
+		}
+
+		snapshot.modelScreenSizes.push_back({ modelName, screenSize });
+	}
+}
+
+void EverettEngine::UpdateModelResidency(const SceneSnapshot& snapshot)
+{
+	const bool overBudget = mainLGL->GetResidentModelBytes() > modelVRAMBudget;
+	std::vector<std::pair<float, const std::string*>> evictionCandidates;
+
+	for (auto& [modelName, unusedTime] : snapshot.unusedModels)
+	{
+		if (!mainLGL->IsModelResident(modelName)) continue;
+
+		if (unusedTime >= modelEvictionIdleTime)
+		{
+			mainLGL->EvictModel(modelName);
+		}
+		else if (overBudget)
+		{
+			evictionCandidates.push_back({ unusedTime, &modelName });
+		}
+	}
+
+	std::sort(evictionCandidates.begin(), evictionCandidates.end(), std::greater{});
+
+	for (auto& [_, modelName] : evictionCandidates)
+	{
+		if (mainLGL->GetResidentModelBytes() <= modelVRAMBudget) break;
+
+		mainLGL->EvictModel(*modelName);
+	}
+}
+
 void EverettEngine::SetupScriptDLL(const std::string& dllPath)
 {
+	auto simLock = LockSimulation();
+
 	if (fileLoader->dllLoader.IsDLLLoaded(dllPath)) return;
 
 	if (fileLoader->dllLoader.LoadDLL(dllPath))
@@ -1194,6 +1892,8 @@ void EverettEngine::UnsetScript(const std::string& dllPath)
 {
 	if (fileLoader)
 	{ 
+		auto simLock = LockSimulation();
+
 		mainLGL->PauseRendering();
 		ClearExternallyControlledContainers();
 		mainLGL->PauseRendering(false);
@@ -1508,6 +2208,8 @@ void EverettEngine::CheckAndLoadRequestedWorld()
 
 bool EverettEngine::SaveWorldToFile(const std::string& filePath)
 {
+	auto simLock = LockSimulation();
+
 	std::string realFilePath = filePath + saveFileType;
 	std::fstream file(realFilePath, std::ios::out);
 
@@ -1651,6 +2353,8 @@ void EverettEngine::LoadScriptDLLsFromLine(std::string_view& line)
 
 bool EverettEngine::LoadWorldFromFile(const std::string& filePath)
 {
+	auto simLock = LockSimulation();
+
 	std::string pathToUse = CheckIfRelativePathToUse(filePath, "worlds");
 
 	std::fstream file(pathToUse, std::ios::in);
@@ -1977,21 +2681,9 @@ void EverettEngine::SetLogCallback(bool value)
 {
 	std::cout.set_rdbuf(value ? logOutput->GetStreamBuffer() : stdOutStreamBuffer);
 	std::cerr.set_rdbuf(value ? errorOutput->GetStreamBuffer() : stdErrStreamBuffer);
+	std::clog.set_rdbuf(value ? debugOutput->GetStreamBuffer() : stdLogStreamBuffer);
 
-	if (value)
-	{
-		logOutput->SetEndlineCallback("AllLog", [this](const std::string& str) { logStrings.push_back(str); });
-		errorOutput->SetEndlineCallback("AllLog", [this](const std::string& str) { logStrings.push_back("ERROR: " + str); });
-
-		EverettException::SetLogReportCreator([this]() { CreateLogReport(); });
-	}
-	else
-	{
-		logOutput->RemoveEndlineCallback("AllLog");
-		errorOutput->RemoveEndlineCallback("AllLog");
-
-		EverettException::SetLogReportCreator(nullptr);
-	}
+	EverettException::SetLogReportCreator(value ? std::function<void()>([this]() { CreateLogReport(); }) : nullptr);
 }
 
 void EverettEngine::SetRenderLoggerCallbacks(bool value)
@@ -2000,27 +2692,38 @@ void EverettEngine::SetRenderLoggerCallbacks(bool value)
 	{
 		if (value)
 		{
-			logger->CreateLogMessage("Trigger render text shader load and custom output buffer set");
-			logOutput->SetEndlineCallback(
-				"RenderLogger", [this](const std::string& str) { logger->CreateLogMessage(str); }, true
-			);
-			errorOutput->SetEndlineCallback(
-				"RenderLogger", [this](const std::string& str) { logger->CreateErrorMessage(str); }, true
+			// Also loads the render text shader, again after texts of LGL were reset
+			logger->CreateTexts();
+			logSystem->AddSink(
+				"RenderLogger",
+				[this](const LogSystem::Entry& entry)
+				{
+					if (entry.level >= LogSystem::Level::Warning)
+					{
+						logger->CreateErrorMessage(entry.text);
+					}
+					else
+					{
+						logger->CreateLogMessage(entry.text);
+					}
+				},
+				true
 			);
 		}
 		else
 		{
-			logOutput->RemoveEndlineCallback("RenderLogger");
-			errorOutput->RemoveEndlineCallback("RenderLogger");
+			logSystem->RemoveSink("RenderLogger");
 		}
 	}
 }
 
 void EverettEngine::CreateLogReport()
 {
+	logSystem->Flush();
+
 	std::fstream file("EverettEngineLogReport-" + GetDateTimeStr() + ".txt", std::ios::out);
 
-	for (auto& str : logStrings)
+	for (auto& str : logSystem->GetHistory())
 	{
 		file << str << '\n';
 	}
@@ -2028,6 +2731,21 @@ void EverettEngine::CreateLogReport()
 	file.close();
 }
 
+void EverettEngine::SetLogLevel(int level)
+{
+	logSystem->SetLevel(static_cast<LogSystem::Level>(std::clamp(level, 0, static_cast<int>(LogSystem::Level::Error))));
+
+	std::cout << "Log level has been set to " << static_cast<int>(logSystem->GetLevel()) << '\n';
+}
+
+void EverettEngine::SetLogFile(const std::string& path)
+{
+	if (!logSystem->SetLogFile(path))
+	{
+		std::cerr << "Failed to open log file " << path << '\n';
+	}
+}
+
 void EverettEngine::PanicOnFailedInterfaceGet(bool value)
 {
 	panicOnFailedInterfaceGet = value;
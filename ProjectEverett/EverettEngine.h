@@ -15,6 +15,10 @@
 #include <optional>
 #include <generator>
 #include <expected>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include "external/IEverettEngine.h"
 #include "external/ColorManager.h"
@@ -34,10 +38,16 @@ class WindowHandleHolder;
 class AnimSystem;
 class RenderLogger;
 class CustomOutput;
+class LogSystem;
 class ModelInfo;
 class KeyScriptFuncInfo;
 class NameTracker;
 class TimerManager;
+class JobSystem;
+struct SceneSnapshot;
+
+template<typename Type>
+class TripleBuffer;
 
 struct HWND__;
 using HWND = HWND__*;
@@ -62,6 +72,10 @@ public:
 
 	EVERETT_API EverettEngine();
 	EVERETT_API ~EverettEngine();
+
+	// GL calls are counted instead of executed, to measure CPU side cost of rendering without a GPU.
+	// Must be called before an engine is created, see nullRenderStats console command
+	EVERETT_API static void EnableNullRenderBackend(bool value = true);
 	EVERETT_API void CreateAndSetupMainWindow(
 		int windowWidth, 
 		int windowHeight, 
@@ -77,6 +91,41 @@ public:
 	EVERETT_API void SetModelPath(const std::string& modelPath);
 
 	EVERETT_API void SetDefaultWASDControls(bool value = true);
+	EVERETT_API void EnableDynamicResolution(bool value = true, float targetFrameTimeMs = 16.6f);
+	EVERETT_API void SetFramesInFlight(size_t amount);
+	// By default one less than the amount of hardware threads, the thread starting parallel work takes part in it
+	EVERETT_API void SetJobWorkerAmount(size_t amount);
+	EVERETT_API size_t GetJobWorkerAmount();
+	EVERETT_API void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func, size_t minBatchSize = 64) override;
+	EVERETT_API void EnableTextureStreaming(bool value = true, size_t vramBudgetMB = 256);
+	// Vertex buffers and textures of loaded models are uploaded by a loader thread with its own GL context,
+	// so heavy models do not stall rendering. Must be called after CreateAndSetupMainWindow, from the same thread
+	EVERETT_API void EnableSharedContextUpload(bool value = true);
+	// Models without solids release their GPU resources after 'idleSeconds', or earlier, 
+	// longest unused first, while models take more than 'vramBudgetMB'. Resources are recreated with a new solid
+	EVERETT_API void SetModelResidencyPolicy(float idleSeconds = 30.0f, size_t vramBudgetMB = 1024);
+	// Frames are rendered only when a sim object changed, a timer fired, an animation or sound is playing,
+	// input was received or a redraw was requested. Otherwise the render thread sleeps
+	EVERETT_API void EnableOnDemandRendering(bool value = true);
+	// Timers, collisions, transforms, animations and scripts run on their own thread, one step ahead of the frame
+	// being rendered, instead of before each frame on the render thread. Must be called before RunRenderWindow
+	EVERETT_API void EnableSimulationThread(bool value = true);
+	// Timers, collisions, transforms and scripts advance in steps of 1 / 'stepsPerSecond' seconds, up to 'maxStepsPerFrame'
+	// steps per frame, and solids are rendered interpolated between their last two states. 0 - a step per frame, the default
+	EVERETT_API void SetFixedSimulationRate(float stepsPerSecond, size_t maxStepsPerFrame = 5);
+	// Game time of animations, timers and movement runs 'scale' times as fast as real time, sounds are not affected
+	EVERETT_API void SetTimeScale(float scale);
+	EVERETT_API float GetTimeScale();
+	// Game time stands still while paused, rendering and input go on
+	EVERETT_API void PauseTime(bool value = true);
+	EVERETT_API bool IsTimePaused();
+	// While paused, advances game time by a single fixed step, or by a frame without a fixed simulation rate
+	EVERETT_API void StepTime();
+	EVERETT_API void RequestRedraw() override;
+	// Renders 'frameCount' frames offscreen with an invisible window and stops, for benchmarks of saved worlds.
+	// Must be called before CreateAndSetupMainWindow
+	EVERETT_API void EnableHeadlessMode(size_t frameCount, float fixedDeltaTime = 0.0f, bool readbackLastFrame = false);
+	EVERETT_API bool SaveLastFrame(const std::string& path);
 	
 	EVERETT_API void EnableGizmoCreation();
 	EVERETT_API void SetGizmoVisible(bool value = true);
@@ -159,6 +208,10 @@ public:
 	EVERETT_API void ResetEngine(const std::optional<EverettStructs::AssetPaths>& assetPaths = std::nullopt);
 
 	EVERETT_API void CreateLogReport() override;
+	// Messages below 'level' are not logged: 0 - debug (debug builds only), 1 - info, 2 - warnings, 3 - errors only
+	EVERETT_API void SetLogLevel(int level);
+	// Log messages are also appended to the file at 'path', empty path stops it
+	EVERETT_API void SetLogFile(const std::string& path);
 	EVERETT_API void PanicOnFailedInterfaceGet(bool value = false) override;
 private:
 	enum ObjectModificationState : bool
@@ -173,6 +226,13 @@ private:
 	bool gizmoVisible = false;
 	bool gizmoEnabled = false;
 
+	bool textureStreamingEnabled = false;
+	bool onDemandRenderingEnabled = false;
+	bool simulationThreadEnabled = false;
+
+	float modelEvictionIdleTime = 30.0f;
+	size_t modelVRAMBudget = 1024ull * 1024 * 1024;
+
 	std::optional<bool> defaultWASDControlsEnabled;
 	bool panicOnFailedInterfaceGet = false;
 
@@ -230,7 +290,8 @@ private:
 	void AddInteractableImpl(
 		int key, bool holdable, std::function<void()> pressFunc, std::function<void()> releaseFunc, bool persistent
 	);
-	void AddTimedCallback(TimedCallbackSetup timedCallbackSetup) override;
+	TimedCallbackHandle AddTimedCallback(TimedCallbackSetup timedCallbackSetup) override;
+	bool CancelTimedCallback(TimedCallbackHandle handle) override;
 	void AddMouseScrollCallback(std::function<void(double)> callback) override;
 	void AddMouseMoveCallback(std::function<void(double, double)> callback) override;
 
@@ -248,7 +309,22 @@ private:
 	ColliderSim* CreateColliderImpl(const std::string& colliderName);
 	void GenerateShader();
 
-	void LightUpdater();
+	void LightUpdater(const SceneSnapshot& snapshot);
+	void UpdateModelScreenSizes(SceneSnapshot& snapshot);
+	void UpdateModelResidency(const SceneSnapshot& snapshot);
+	bool IsPlaybackActive();
+	void UpdateAllTransforms();
+	void ProcessAllAnimations();
+
+	std::unique_lock<std::recursive_mutex> LockSimulation();
+	void RunOnSimulationThread(std::function<void()> func);
+	void ExecuteSimulationCommands();
+	void SimulationLoop();
+	void SimulationStep();
+	bool SimulationTick(float tickTime);
+	void StorePreviousTransforms();
+	void WriteSnapshot(SceneSnapshot& snapshot);
+	void ApplySnapshot();
 
 	ObjectSim* GetObjectFromMap(
 		ObjectTypes objectType,
@@ -307,6 +383,30 @@ private:
 	std::unique_ptr<AnimSystem> animSystem;
 	std::unique_ptr<RenderLogger> logger;
 	std::unique_ptr<TimerManager> timerManager;
+	std::unique_ptr<JobSystem> jobSystem;
+	std::vector<ObjectSim*> transformUpdateList;
+
+	// Simulation runs for the snapshot after the one being rendered, waits for the render thread to pick it up
+	constexpr static std::chrono::milliseconds simulationIdleTick{ 100 };
+
+	std::unique_ptr<TripleBuffer<SceneSnapshot>> snapshotBuffer;
+	const SceneSnapshot* renderSnapshot = nullptr;
+	size_t snapshotIndex = 0;
+
+	std::thread simulationThread;
+	std::atomic<bool> simulationRunning = false;
+	// Held by the simulation thread for a step, and by the other threads changing the scene while it runs
+	std::recursive_mutex simulationMux;
+	std::mutex snapshotMux;
+	std::condition_variable snapshotConsumedCondVar;
+	// Input callbacks of the render thread, executed at the start of the next step
+	std::mutex simulationCommandMux;
+	std::vector<std::function<void()>> simulationCommands;
+
+	std::atomic<float> fixedStepTime = 0.0f; // 0 - a step per frame
+	size_t maxStepsPerFrame = 5;
+	float stepAccumulator = 0.0f;
+	float interpolationAlpha = 1.0f;
 
 	ModelCollection models;
 	SolidCollection solids;
@@ -316,6 +416,7 @@ private:
 
 	static LightShaderValueNames lightShaderValueNames;
 	static std::vector<ObjectTypeInfo> objectTypes;
+	static bool nullRenderBackend;
 
 	std::map<int, KeyScriptFuncInfo> keyScriptFuncMap;
 	std::vector<std::function<void(double)>> mouseScrollScriptFuncs;
@@ -325,10 +426,13 @@ private:
 
 	std::streambuf* stdOutStreamBuffer;
 	std::streambuf* stdErrStreamBuffer;
+	std::streambuf* stdLogStreamBuffer;
 
+	// Outputs write into the log system, so it is destroyed after them
+	std::unique_ptr<LogSystem> logSystem;
 	std::unique_ptr<CustomOutput> logOutput;
 	std::unique_ptr<CustomOutput> errorOutput;
-	std::list<std::string> logStrings;
+	std::unique_ptr<CustomOutput> debugOutput; // std::clog, compiled out of release builds
 
 	std::function<void()> worldLoadCallback;
 	std::string worldToLoad;
@@ -143,35 +143,98 @@ void FileLoader::DeleteAllAbsentAssets(const EverettStructs::AssetPaths& assetPa
 	dllLoader.FreeDllData();
 }
 
+void FileLoader::ModelLoader::SetJobSystem(JobSystem* jobSystem)
+{
+	this->jobSystem = jobSystem;
+}
+
+// Decoding is the heaviest part of model loading, textures are decoded in parallel
+// and collected by CollectDecodedTextures before the model is returned
 bool FileLoader::ModelLoader::LoadTexture(
 	const std::string& file, 
 	LGLStructs::Texture& texture, 
 	std::span<unsigned char> data
 )
 {
-	stbi_set_flip_vertically_on_load(data.empty());
+	std::string textureName = texture.name.size() ? texture.name : file;
+
+	while (textureName.find('\\') != std::string::npos)
+	{
+		textureName = textureName.substr(textureName.find('\\') + 1);
+	}
+
+	texture.name = textureName;
+	ownerContainer[file].textureMap[texture.name] = nullptr;
+
+	// Meshes sharing a texture wait for the same decode
+	if (textureDecodes.contains(texture.name))
+	{
+		return true;
+	}
+
+	auto decode = [file, data, &res = textureDecodes[texture.name]]()
+	{
+		stbi_set_flip_vertically_on_load_thread(data.empty());
+
+		res.data = !data.empty() ?
+			stbi_load_from_memory(
+				data.data(), static_cast<int>(data.size()), &res.width, &res.height, &res.channelAmount, 0
+			) : stbi_load(file.c_str(), &res.width, &res.height, &res.channelAmount, 0);
+	};
+
+	if (jobSystem)
+	{
+		jobSystem->Schedule(std::move(decode), &textureDecodeCounter);
+	}
+	else
+	{
+		decode();
+	}
 
-	texture.data = !data.empty() ?
-		stbi_load_from_memory(
-			data.data(), static_cast<int>(data.size()), &texture.width, &texture.height, &texture.channelAmount, 0
-		) : stbi_load(file.c_str(), &texture.width, &texture.height, &texture.channelAmount, 0);
+	return true;
+}
+
+void FileLoader::ModelLoader::CollectDecodedTextures(LGLStructs::ModelInfo& model)
+{
+	auto& textureMap = ownerContainer[fileProcessed].textureMap;
 
-	if (texture.data)
+	if (jobSystem)
 	{
-		std::string textureName = texture.name.size() ? texture.name : file;
+		jobSystem->Wait(textureDecodeCounter);
+	}
+
+	std::unordered_map<std::string, DecodedTexture> decodedTextures;
+	decodedTextures.swap(textureDecodes);
 
-		while (textureName.find('\\') != std::string::npos)
+	for (auto& [textureName, decodedTexture] : decodedTextures)
+	{
+		if (!decodedTexture.data)
 		{
-			textureName = textureName.substr(textureName.find('\\') + 1);
+			std::cerr << "Failed to decode texture " << textureName << '\n';
 		}
 
-		texture.name = textureName;
-		ownerContainer[file].textureMap[texture.name] = texture.data;
-
-		return true;
+		textureMap[textureName] = decodedTexture.data;
 	}
 
-	return false;
+	for (auto& meshInfo : model.meshes)
+	{
+		auto& textures = meshInfo.mesh.textures;
+
+		for (auto& texture : textures)
+		{
+			auto decodedIter = decodedTextures.find(texture.name);
+
+			if (decodedIter != decodedTextures.end())
+			{
+				texture.data = decodedIter->second.data;
+				texture.width = decodedIter->second.width;
+				texture.height = decodedIter->second.height;
+				texture.channelAmount = decodedIter->second.channelAmount;
+			}
+		}
+
+		std::erase_if(textures, [](const LGLStructs::Texture& texture) { return !texture.data; });
+	}
 }
 
 FileLoader::FileLoader() {}
@@ -375,6 +438,11 @@ LGLStructs::Mesh FileLoader::ModelLoader::ProcessMesh(
 
 				newTexture.name = nameToSet + '_' + strWithoutPrefix.data();
 				newTexture.type = textureTypeInfo[texTypeIndex].lglTexType;
+				// Trilinear filtered, block compressed mip chain is produced on configuration in LGL
+				newTexture.params.createMipmaps = true;
+				newTexture.params.compress = true;
+				newTexture.params.BFConfig.maxFilter = false;
+				newTexture.params.mipmapBFConfig.minFilter = false;
 
 				const aiTexture* embeddedTexture = modelHandle->GetEmbeddedTexture(strWithoutPrefix.data());
 
@@ -394,10 +462,8 @@ LGLStructs::Mesh FileLoader::ModelLoader::ProcessMesh(
 					newTexture = tempTexMap[newTexture.name];
 				}
 
-				if (newTexture.data)
-				{
-					mesh.textures.push_back(std::move(newTexture));
-				}
+				// Data is filled in once decoding finishes, see CollectDecodedTextures
+				mesh.textures.push_back(std::move(newTexture));
 			}
 		};
 
@@ -596,6 +662,7 @@ bool FileLoader::ModelLoader::LoadModel(
 		auto& modelAnimPtr = ownerContainer[file].modelAnim;
 
 		ProcessNodeForModelInfo(modelHandle->mRootNode, model, boneMap, tempTexMap);
+		CollectDecodedTextures(*modelPtr);
 		modelPtr->RecheckIfTextureless();
 		modelPtr->NormalizeAllEmptyWeights();
 
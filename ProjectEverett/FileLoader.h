@@ -13,6 +13,7 @@
 #include <span>
 
 #include "AnimSystem.h"
+#include "JobSystem.h"
 
 // Assimp forward declarations
 struct aiScene;
@@ -69,6 +70,19 @@ class FileLoader
 		using BoneMap = std::unordered_map<std::string, AnimSystem::BoneInfo>;
 		using TempTexMap = std::unordered_map<std::string, LGLStructs::Texture>;
 
+		struct DecodedTexture
+		{
+			LGLStructs::Texture::TextureData data = nullptr;
+			int width{};
+			int height{};
+			int channelAmount{};
+		};
+
+		// Elements keep their address, decode jobs write straight into them
+		std::unordered_map<std::string, DecodedTexture> textureDecodes;
+		JobSystem::Counter textureDecodeCounter;
+		JobSystem* jobSystem = nullptr;
+
 		void ProcessNodeForModelInfo(
 			const aiNode* nodeHandle,
 			std::weak_ptr<LGLStructs::ModelInfo> model,
@@ -101,7 +115,11 @@ class FileLoader
 			LGLStructs::Texture& texture,
 			std::span<unsigned char> data
 		);
+		void CollectDecodedTextures(LGLStructs::ModelInfo& model);
 	public:
+		// Textures are decoded by jobs of 'jobSystem', without it on the loading thread
+		void SetJobSystem(JobSystem* jobSystem);
+
 		bool LoadModel(
 			const std::string& file,
 			const std::string& name,
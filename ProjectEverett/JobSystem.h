@@ -0,0 +1,353 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <span>
+#include <algorithm>
+
+/*
+	Pool of workers with a job deque each. Workers take jobs from the back of their own deque
+	and steal from the front of the others once it is empty. Threads waiting for a counter
+	execute jobs meanwhile, so jobs can schedule and wait for other jobs. Without workers jobs run on scheduling
+*/
+class JobSystem
+{
+public:
+	// Amount of unfinished jobs. Jobs scheduled with a counter as their dependency start once it reaches zero
+	class Counter
+	{
+		friend class JobSystem;
+
+		std::atomic<size_t> pending = 0;
+		std::mutex continuationMux;
+		std::vector<std::function<void()>> continuations;
+
+	public:
+		bool IsDone() const
+		{
+			return pending == 0;
+		}
+	};
+
+private:
+	struct Job
+	{
+		std::function<void()> func;
+		Counter* counter = nullptr;
+	};
+
+	struct Worker
+	{
+		std::mutex jobsMux;
+		std::deque<Job> jobs;
+		std::thread thread;
+	};
+
+	// Parallel loops are split into up to this amount of batches per thread, so stealing can even the load out
+	constexpr static size_t BatchesPerThread = 4;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<size_t> queuedJobs = 0;
+	std::atomic<size_t> nextWorker = 0;
+	std::atomic<bool> stopWorkers = false;
+
+	std::mutex sleepMux;
+	std::condition_variable sleepCondVar;
+
+	static inline thread_local JobSystem* currentSystem = nullptr;
+	static inline thread_local size_t currentWorkerIndex = 0;
+
+	void Push(Job&& job)
+	{
+		if (workers.empty())
+		{
+			RunJob(job);
+			return;
+		}
+
+		// Workers keep their own jobs local, other threads spread them
+		const size_t workerIndex =
+			currentSystem == this ? currentWorkerIndex : nextWorker.fetch_add(1) % workers.size();
+
+		{
+			std::lock_guard<std::mutex> lock(workers[workerIndex]->jobsMux);
+			workers[workerIndex]->jobs.push_back(std::move(job));
+		}
+
+		++queuedJobs;
+
+		{
+			std::lock_guard<std::mutex> lock(sleepMux);
+		}
+		sleepCondVar.notify_one();
+	}
+
+	bool PopJob(Job& job)
+	{
+		if (workers.empty())
+		{
+			return false;
+		}
+
+		const bool isWorker = currentSystem == this;
+		const size_t startIndex = isWorker ? currentWorkerIndex : nextWorker.load() % workers.size();
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			Worker& worker = *workers[(startIndex + i) % workers.size()];
+			std::lock_guard<std::mutex> lock(worker.jobsMux);
+
+			if (worker.jobs.empty())
+			{
+				continue;
+			}
+
+			// Own jobs are the most recent ones and still hot in cache, stolen ones are the oldest
+			if (isWorker && i == 0)
+			{
+				job = std::move(worker.jobs.back());
+				worker.jobs.pop_back();
+			}
+			else
+			{
+				job = std::move(worker.jobs.front());
+				worker.jobs.pop_front();
+			}
+
+			--queuedJobs;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void FinishJob(Counter* counter)
+	{
+		if (!counter)
+		{
+			return;
+		}
+
+		std::vector<std::function<void()>> continuations;
+
+		{
+			// Counter is not touched after the unlock, waiters lock it before they may destroy it
+			std::lock_guard<std::mutex> lock(counter->continuationMux);
+
+			if (--counter->pending)
+			{
+				return;
+			}
+
+			continuations.swap(counter->continuations);
+		}
+
+		for (auto& continuation : continuations)
+		{
+			continuation();
+		}
+	}
+
+	void RunJob(Job& job)
+	{
+		job.func();
+		FinishJob(job.counter);
+	}
+
+	bool RunOneJob()
+	{
+		Job job;
+
+		if (!PopJob(job))
+		{
+			return false;
+		}
+
+		RunJob(job);
+
+		return true;
+	}
+
+	void WorkerLoop(size_t workerIndex)
+	{
+		currentSystem = this;
+		currentWorkerIndex = workerIndex;
+
+		while (!stopWorkers)
+		{
+			if (!RunOneJob())
+			{
+				std::unique_lock<std::mutex> lock(sleepMux);
+				sleepCondVar.wait(lock, [this]() { return stopWorkers || queuedJobs > 0; });
+			}
+		}
+	}
+
+	void StopWorkers()
+	{
+		stopWorkers = true;
+
+		{
+			std::lock_guard<std::mutex> lock(sleepMux);
+		}
+		sleepCondVar.notify_all();
+
+		for (auto& worker : workers)
+		{
+			worker->thread.join();
+		}
+
+		std::vector<std::unique_ptr<Worker>> stoppedWorkers;
+		stoppedWorkers.swap(workers);
+
+		queuedJobs = 0;
+		stopWorkers = false;
+
+		// Jobs left behind are finished here, so no counter is left waiting forever
+		for (auto& worker : stoppedWorkers)
+		{
+			for (auto& job : worker->jobs)
+			{
+				RunJob(job);
+			}
+		}
+	}
+
+public:
+	// Thread calling ParallelFor or Wait works too, so by default one worker less than hardware threads
+	static size_t GetDefaultWorkerAmount()
+	{
+		const size_t hardwareThreads = std::thread::hardware_concurrency();
+
+		return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	JobSystem(size_t workerAmount = GetDefaultWorkerAmount())
+	{
+		SetWorkerAmount(workerAmount);
+	}
+
+	~JobSystem()
+	{
+		StopWorkers();
+	}
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Must not be called from a job or while other threads schedule jobs. Queued jobs are finished first
+	void SetWorkerAmount(size_t amount)
+	{
+		StopWorkers();
+
+		for (size_t i = 0; i < amount; ++i)
+		{
+			workers.push_back(std::make_unique<Worker>());
+		}
+
+		for (size_t i = 0; i < amount; ++i)
+		{
+			workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+		}
+	}
+
+	size_t GetWorkerAmount()
+	{
+		return workers.size();
+	}
+
+	// 'counter' is incremented right away and decremented once the job is finished.
+	// With 'dependency' set the job is queued only after the dependency counter reaches zero
+	void Schedule(std::function<void()> func, Counter* counter = nullptr, Counter* dependency = nullptr)
+	{
+		if (counter)
+		{
+			++counter->pending;
+		}
+
+		if (dependency)
+		{
+			std::lock_guard<std::mutex> lock(dependency->continuationMux);
+
+			if (!dependency->IsDone())
+			{
+				dependency->continuations.push_back(
+					[this, func = std::move(func), counter]() mutable { Push(Job{ std::move(func), counter }); }
+				);
+
+				return;
+			}
+		}
+
+		Push(Job{ std::move(func), counter });
+	}
+
+	// Executes queued jobs until the counter reaches zero
+	void Wait(Counter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!RunOneJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// Last job to finish may still hold the lock
+		std::lock_guard<std::mutex> lock(counter.continuationMux);
+	}
+
+	// Calls 'func' with [begin, end) ranges covering [0, count), the calling thread takes the first range.
+	// Ranges are not shorter than 'minBatchSize' unless the count itself is
+	void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func, size_t minBatchSize = 64)
+	{
+		if (!count)
+		{
+			return;
+		}
+
+		const size_t maxBatchAmount = (workers.size() + 1) * BatchesPerThread;
+		const size_t batchAmount = std::clamp<size_t>(count / std::max<size_t>(minBatchSize, 1), 1, maxBatchAmount);
+
+		if (batchAmount == 1 || workers.empty())
+		{
+			func(0, count);
+			return;
+		}
+
+		const size_t batchSize = (count + batchAmount - 1) / batchAmount;
+		Counter counter;
+
+		for (size_t begin = batchSize; begin < count; begin += batchSize)
+		{
+			const size_t end = std::min(begin + batchSize, count);
+			Schedule([&func, begin, end]() { func(begin, end); }, &counter);
+		}
+
+		func(0, batchSize);
+		Wait(counter);
+	}
+
+	template<typename Type, typename Func>
+	void ParallelFor(std::span<Type> items, Func&& func, size_t minBatchSize = 64)
+	{
+		ParallelFor(
+			items.size(),
+			[&items, &func](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					func(items[i]);
+				}
+			},
+			minBatchSize
+		);
+	}
+};
@@ -0,0 +1,521 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <array>
+#include <map>
+#include <memory>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Messages below are compiled out of Log<Level> calls: 0 - debug, 1 - info, 2 - warnings, 3 - errors only
+#ifndef EVERETT_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define EVERETT_LOG_MIN_LEVEL 0
+#else
+#define EVERETT_LOG_MIN_LEVEL 1
+#endif
+#endif
+
+/*
+	Producers write fixed size records into a ring buffer of their own thread, never taking a lock or waiting for the output.
+	A background thread collects records of all threads, formats them and passes them to sinks,
+	formatted lines are also kept in a bounded history. Messages which do not fit into a full ring are dropped and counted
+*/
+class LogSystem
+{
+public:
+	enum class Level : uint8_t
+	{
+		Debug, Info, Warning, Error, _SIZE
+	};
+
+	constexpr static Level compiledLevel = static_cast<Level>(EVERETT_LOG_MIN_LEVEL);
+
+	struct Entry
+	{
+		Level level;
+		std::chrono::system_clock::time_point time;
+		size_t threadIndex;
+		std::string text;
+	};
+
+	using Sink = std::function<void(const Entry&)>;
+
+private:
+	constexpr static size_t recordTextSize = 224;
+	constexpr static size_t ringCapacity = 512; // Power of two
+	constexpr static size_t maxRecordsPerMessage = ringCapacity / 8; // Longer messages are truncated
+	constexpr static size_t maxManualPending = 1024;
+	constexpr static std::chrono::milliseconds collectInterval{ 10 };
+
+	struct Record
+	{
+		uint64_t sequence;
+		std::chrono::system_clock::time_point time;
+		Level level;
+		bool continued; // Text of the message goes on in the next record
+		uint16_t length;
+		char text[recordTextSize];
+	};
+
+	// Single producer, the owning thread, and single consumer, the sink thread
+	struct Ring
+	{
+		std::array<Record, ringCapacity> records;
+		std::atomic<size_t> head = 0;
+		std::atomic<size_t> tail = 0;
+		std::atomic<bool> abandoned = false; // Owning thread has exited
+		size_t threadIndex{};
+	};
+
+	struct ThreadRing
+	{
+		uint64_t ownerId{};
+		std::shared_ptr<Ring> ring;
+
+		~ThreadRing()
+		{
+			if (ring)
+			{
+				ring->abandoned = true;
+			}
+		}
+	};
+
+	static inline std::atomic<uint64_t> lastInstanceId = 0;
+
+	const uint64_t instanceId;
+
+	std::mutex ringsMux;
+	std::vector<std::shared_ptr<Ring>> rings;
+	size_t nextThreadIndex = 0;
+
+	std::atomic<Level> runtimeLevel = std::max(Level::Info, compiledLevel);
+	std::atomic<uint64_t> nextSequence = 0;
+	std::atomic<size_t> droppedAmount = 0;
+
+	std::mutex sinksMux;
+	std::map<std::string, std::pair<Sink, bool>> sinks; // Sink with manual execution flag
+	std::deque<Entry> manualPending;
+	size_t manualDroppedAmount = 0;
+	std::ofstream logFile;
+
+	std::mutex historyMux;
+	std::deque<std::string> history;
+	size_t historyCapacity = 10000;
+
+	std::mutex collectMux;
+	std::condition_variable collectCondVar;
+	std::condition_variable flushedCondVar;
+	uint64_t processedSequence = 0;
+	bool flushRequested = false;
+	bool stopCollector = false;
+	std::atomic<bool> wakeRequested = false; // Ring of a producer got half full, set without the lock
+	std::thread collector;
+
+	Ring& GetThreadRing()
+	{
+		static thread_local ThreadRing threadRing;
+
+		if (threadRing.ownerId != instanceId)
+		{
+			if (threadRing.ring)
+			{
+				threadRing.ring->abandoned = true;
+			}
+
+			threadRing.ring = std::make_shared<Ring>();
+			threadRing.ownerId = instanceId;
+
+			std::lock_guard<std::mutex> lock(ringsMux);
+			threadRing.ring->threadIndex = nextThreadIndex++;
+			rings.push_back(threadRing.ring);
+		}
+
+		return *threadRing.ring;
+	}
+
+	// Messages of a thread are complete in its ring, a message is never split between two collections
+	void CollectRing(Ring& ring, std::vector<std::pair<uint64_t, Entry>>& collected)
+	{
+		const size_t head = ring.head.load(std::memory_order_acquire);
+		size_t tail = ring.tail.load(std::memory_order_relaxed);
+
+		while (tail != head)
+		{
+			const Record& first = ring.records[tail & (ringCapacity - 1)];
+			Entry entry{ first.level, first.time, ring.threadIndex };
+
+			while (true)
+			{
+				const Record& record = ring.records[tail++ & (ringCapacity - 1)];
+				entry.text.append(record.text, record.length);
+
+				if (!record.continued)
+				{
+					break;
+				}
+			}
+
+			collected.emplace_back(first.sequence, std::move(entry));
+		}
+
+		ring.tail.store(tail, std::memory_order_release);
+	}
+
+	static std::string Format(const Entry& entry)
+	{
+		constexpr std::array<const char*, static_cast<size_t>(Level::_SIZE)> levelPrefixes = {
+			"DEBUG: ", "", "WARNING: ", "ERROR: "
+		};
+
+		return std::format(
+			"[{:%H:%M:%S}] {}{}",
+			std::chrono::current_zone()->to_local(std::chrono::floor<std::chrono::milliseconds>(entry.time)),
+			levelPrefixes[static_cast<size_t>(entry.level)],
+			entry.text
+		);
+	}
+
+	void Dispatch(Entry&& entry)
+	{
+		std::string line = Format(entry);
+
+		{
+			std::lock_guard<std::mutex> lock(sinksMux);
+
+			if (logFile.is_open())
+			{
+				logFile << line << '\n';
+			}
+
+			bool manualSinkSet = false;
+
+			for (auto& [_, sinkPair] : sinks)
+			{
+				if (sinkPair.second)
+				{
+					manualSinkSet = true;
+				}
+				else if (sinkPair.first)
+				{
+					sinkPair.first(entry);
+				}
+			}
+
+			if (manualSinkSet)
+			{
+				if (manualPending.size() == maxManualPending)
+				{
+					manualPending.pop_front();
+					++manualDroppedAmount;
+				}
+
+				manualPending.push_back(std::move(entry));
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(historyMux);
+
+		if (history.size() == historyCapacity)
+		{
+			history.pop_front();
+		}
+
+		history.push_back(std::move(line));
+	}
+
+	void Collect()
+	{
+		std::vector<std::shared_ptr<Ring>> currentRings;
+
+		{
+			std::lock_guard<std::mutex> lock(ringsMux);
+
+			std::erase_if(rings, [](const std::shared_ptr<Ring>& ring)
+			{
+				return ring->abandoned && ring->head.load() == ring->tail.load();
+			});
+
+			currentRings = rings;
+		}
+
+		std::vector<std::pair<uint64_t, Entry>> collected;
+
+		for (auto& ring : currentRings)
+		{
+			CollectRing(*ring, collected);
+		}
+
+		// Messages of different threads are ordered within a collection
+		std::sort(collected.begin(), collected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		uint64_t lastSequence = 0;
+
+		for (auto& [sequence, entry] : collected)
+		{
+			lastSequence = std::max(lastSequence, sequence + 1);
+			Dispatch(std::move(entry));
+		}
+
+		if (const size_t dropped = droppedAmount.exchange(0))
+		{
+			Dispatch({ Level::Warning, std::chrono::system_clock::now(), 0, std::to_string(dropped) + " log messages dropped" });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(sinksMux);
+
+			if (logFile.is_open())
+			{
+				logFile.flush();
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(collectMux);
+		processedSequence = std::max(processedSequence, lastSequence);
+		flushedCondVar.notify_all();
+	}
+
+	void CollectorLoop()
+	{
+		while (true)
+		{
+			bool stopping;
+
+			{
+				std::unique_lock<std::mutex> lock(collectMux);
+				collectCondVar.wait_for(
+					lock, collectInterval, [this]() { return stopCollector || flushRequested || wakeRequested; }
+				);
+
+				flushRequested = false;
+				wakeRequested.store(false, std::memory_order_relaxed);
+				stopping = stopCollector;
+			}
+
+			Collect();
+
+			if (stopping)
+			{
+				break;
+			}
+		}
+	}
+
+public:
+	LogSystem()
+		: instanceId(++lastInstanceId)
+	{
+		collector = std::thread(&LogSystem::CollectorLoop, this);
+	}
+
+	// Messages logged so far are still passed to sinks
+	~LogSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(collectMux);
+			stopCollector = true;
+		}
+		collectCondVar.notify_all();
+		collector.join();
+	}
+
+	LogSystem(const LogSystem&) = delete;
+	LogSystem& operator=(const LogSystem&) = delete;
+
+	// Any thread, never blocks
+	void Log(Level level, std::string_view text)
+	{
+		if (level < runtimeLevel.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		Ring& ring = GetThreadRing();
+
+		const size_t recordAmount = std::clamp<size_t>((text.size() + recordTextSize - 1) / recordTextSize, 1, maxRecordsPerMessage);
+		const size_t head = ring.head.load(std::memory_order_relaxed);
+
+		if (ringCapacity - (head - ring.tail.load(std::memory_order_acquire)) < recordAmount)
+		{
+			++droppedAmount;
+			return;
+		}
+
+		const uint64_t sequence = nextSequence++;
+		const auto time = std::chrono::system_clock::now();
+
+		for (size_t i = 0; i < recordAmount; ++i)
+		{
+			Record& record = ring.records[(head + i) & (ringCapacity - 1)];
+			const std::string_view part = text.substr(std::min(i * recordTextSize, text.size()), recordTextSize);
+
+			record.sequence = sequence;
+			record.time = time;
+			record.level = level;
+			record.continued = i + 1 < recordAmount;
+			record.length = static_cast<uint16_t>(part.size());
+			std::memcpy(record.text, part.data(), part.size());
+		}
+
+		ring.head.store(head + recordAmount, std::memory_order_release);
+
+		// Bursts wake the collector up early instead of waiting for its interval. Without the lock a notification
+		// can still slip in before the collector waits, the flag then ends its wait at the next check or interval
+		if (head - ring.tail.load(std::memory_order_relaxed) < ringCapacity / 2 &&
+			head + recordAmount - ring.tail.load(std::memory_order_relaxed) >= ringCapacity / 2)
+		{
+			wakeRequested.store(true, std::memory_order_relaxed);
+			collectCondVar.notify_one();
+		}
+	}
+
+	// Compiled out below EVERETT_LOG_MIN_LEVEL
+	template<Level level>
+	void Log(std::string_view text)
+	{
+		if constexpr (level >= compiledLevel)
+		{
+			Log(level, text);
+		}
+	}
+
+	using FilteredLog = void (LogSystem::*)(std::string_view);
+
+	// Log<Level> for a level known at runtime only, resolved once by long lived producers such as streams
+	static FilteredLog GetFilteredLog(Level level)
+	{
+		switch (level)
+		{
+		case Level::Debug:
+			return &LogSystem::Log<Level::Debug>;
+		case Level::Info:
+			return &LogSystem::Log<Level::Info>;
+		case Level::Warning:
+			return &LogSystem::Log<Level::Warning>;
+		default:
+			return &LogSystem::Log<Level::Error>;
+		}
+	}
+
+	// Not lower than the compiled level
+	void SetLevel(Level level)
+	{
+		runtimeLevel = std::max(level, compiledLevel);
+	}
+
+	Level GetLevel()
+	{
+		return runtimeLevel;
+	}
+
+	// Sinks are called by the background thread, manual ones by whoever calls ExecuteManualSinks
+	void AddSink(const std::string& key, Sink sink, bool manualExecution = false)
+	{
+		std::lock_guard<std::mutex> lock(sinksMux);
+		sinks[key] = { std::move(sink), manualExecution };
+	}
+
+	void RemoveSink(const std::string& key)
+	{
+		std::lock_guard<std::mutex> lock(sinksMux);
+		sinks.erase(key);
+	}
+
+	// Up to the last 1024 messages since the previous call, older ones are counted as dropped
+	void ExecuteManualSinks()
+	{
+		std::lock_guard<std::mutex> lock(sinksMux);
+
+		if (manualPending.empty())
+		{
+			return;
+		}
+
+		if (manualDroppedAmount)
+		{
+			manualPending.push_front({ Level::Warning, std::chrono::system_clock::now(), 0,
+				std::to_string(manualDroppedAmount) + " log messages skipped" });
+			manualDroppedAmount = 0;
+		}
+
+		for (auto& [_, sinkPair] : sinks)
+		{
+			if (sinkPair.second && sinkPair.first)
+			{
+				for (const Entry& entry : manualPending)
+				{
+					sinkPair.first(entry);
+				}
+			}
+		}
+
+		manualPending.clear();
+	}
+
+	// Formatted messages are appended to the file at 'path', empty path closes it
+	bool SetLogFile(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(sinksMux);
+
+		logFile.close();
+
+		if (path.empty())
+		{
+			return true;
+		}
+
+		logFile.open(path, std::ios::out | std::ios::app);
+
+		return logFile.is_open();
+	}
+
+	void SetHistoryCapacity(size_t capacity)
+	{
+		std::lock_guard<std::mutex> lock(historyMux);
+
+		historyCapacity = std::max<size_t>(capacity, 1);
+
+		while (history.size() > historyCapacity)
+		{
+			history.pop_front();
+		}
+	}
+
+	std::vector<std::string> GetHistory()
+	{
+		std::lock_guard<std::mutex> lock(historyMux);
+
+		return { history.begin(), history.end() };
+	}
+
+	// Waits until messages logged before the call are passed to sinks, up to 'timeout'
+	void Flush(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000))
+	{
+		if (std::this_thread::get_id() == collector.get_id())
+		{
+			return;
+		}
+
+		const uint64_t target = nextSequence.load();
+
+		std::unique_lock<std::mutex> lock(collectMux);
+		flushRequested = true;
+		collectCondVar.notify_all();
+
+		flushedCondVar.wait_for(lock, timeout, [this, target]() { return processedSequence >= target || stopCollector; });
+	}
+};
@@ -4,7 +4,14 @@
 #include <algorithm>
 
 ModelInfo::ModelInfo(const std::string& modelPath, FullModelInfo&& model)
-	: modelPath(modelPath), model(std::move(model)) {}
+	: modelPath(modelPath), model(std::move(model)) 
+{
+	// Extent is needed every frame, going through all vertices each time is not an option
+	if (auto modelPtr = this->model.first.lock())
+	{
+		modelExtent = 1.0f / modelPtr->GetAutoScaleForModel().x;
+	}
+}
 
 ModelInfo::~ModelInfo()
 {
@@ -16,6 +23,38 @@ void ModelInfo::RecheckIfAllRelatedSolidsAreVisible()
 	model.first.lock()->render = std::any_of(
 		relatedSolids.begin(), relatedSolids.end(), [](SolidSim* solid) { return solid->GetModelVisibility(); }
 	);
+
+	RecheckAllMeshVisibility();
+}
+
+void ModelInfo::RecheckAllMeshVisibility()
+{
+	size_t meshAmount = model.first.lock()->meshes.size();
+
+	for (size_t meshIndex = 0; meshIndex < meshAmount; ++meshIndex)
+	{
+		RecheckMeshVisibility(meshIndex);
+	}
+}
+
+// Mesh hidden in every related solid is skipped by LGL, no draw call is issued for it
+void ModelInfo::RecheckMeshVisibility(size_t meshIndex)
+{
+	auto& meshRender = model.first.lock()->meshes[meshIndex].render;
+
+	bool anySolidShowsMesh = std::any_of(
+		relatedSolids.begin(), relatedSolids.end(), 
+		[meshIndex](SolidSim* solid) { return solid->GetModelVisibility() && solid->GetModelMeshVisibility(meshIndex); }
+	);
+
+	if (anySolidShowsMesh)
+	{
+		meshRender.ResetValue();
+	}
+	else
+	{
+		meshRender = false;
+	}
 }
 
 void ModelInfo::SetModelNamePtr(const std::string& modelAddr)
@@ -35,6 +74,21 @@ const std::string& ModelInfo::GetModelPath() const
 	return modelPath;
 }
 
+float ModelInfo::GetModelExtent() const
+{
+	return modelExtent;
+}
+
+float ModelInfo::GetUnusedTime() const
+{
+	if (!relatedSolids.empty())
+	{
+		return 0.0f;
+	}
+
+	return std::chrono::duration<float>(EngineClock::GetRealTime() - unusedSince).count();
+}
+
 void ModelInfo::InsertRelatedSolid(SolidSim& solid)
 {
 	CheckModelNamePtrSet();
@@ -46,6 +100,8 @@ void ModelInfo::InsertRelatedSolid(SolidSim& solid)
 
 	solid.STMM.InitializeSTMM(*this, modelNamePtr);
 	relatedSolids.insert(&solid);
+
+	RecheckAllMeshVisibility();
 }
 
 void ModelInfo::EraseFromRelatedSolids(SolidSim& solid)
@@ -55,6 +111,11 @@ void ModelInfo::EraseFromRelatedSolids(SolidSim& solid)
 	if (relatedSolids.empty())
 	{
 		SetupModelInfo(false);
+		unusedSince = EngineClock::GetRealTime();
+	}
+	else
+	{
+		RecheckAllMeshVisibility();
 	}
 }
 
@@ -93,6 +154,7 @@ void ModelInfo::SetupModelInfo(bool set)
 			for (auto& mesh : modelPtr->meshes)
 			{
 				mesh.behaviour.ResetValue();
+				mesh.render.ResetValue();
 			}
 		}
 	}
@@ -3,9 +3,11 @@
 #include <string>
 #include <unordered_set>
 #include <functional>
+#include <chrono>
 
 #include "LGLStructs.h"
 #include "AnimSystem.h"
+#include "EngineClock.h"
 
 class SolidSim;
 
@@ -20,9 +22,14 @@ public:
 	~ModelInfo();
 
 	void RecheckIfAllRelatedSolidsAreVisible();
+	void RecheckMeshVisibility(size_t meshIndex);
+	void RecheckAllMeshVisibility();
 	void SetModelNamePtr(const std::string& modelAddr);
 	const std::string& GetModelName() const;
 	const std::string& GetModelPath() const;
+	float GetModelExtent() const;
+	// Seconds since the last related solid was removed, 0 while model has solids
+	float GetUnusedTime() const;
 
 	template<typename Self>
 	auto&& GetFullModelInfo(this Self&& self)
@@ -44,6 +51,8 @@ private:
 
 	const std::string* modelNamePtr{};
 	std::string modelPath;
+	float modelExtent{};
+	EngineClock::TimePoint unusedSince = EngineClock::GetRealTime();
 	FullModelInfo model;
 	std::unordered_set<SolidSim*> relatedSolids;
 };
\ No newline at end of file
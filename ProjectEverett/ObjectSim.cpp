@@ -31,7 +31,7 @@ ObjectSim::ObjectSim(
 	const glm::vec3& scale,
 	const float speed
 )
-	: pos(pos), scale(scale), speed(speed), visited(false), objectLinkingEnabled(true), 
+	: pos(pos), scale(scale), speed(speed), visited(false), transformChanged(false), objectLinkingEnabled(true), 
 	  orient({1.0f, 0.0f, 0.0f, 0.0f})
 {
 	rotationLimits = {
@@ -275,9 +275,31 @@ size_t ObjectSim::GetAmountOfDisabledDirs()
 }
 
 bool ObjectSim::UpdateTransform()
+{
+	const bool changed = ApplyTransformChanges();
+	FlushTransformCallbacks();
+
+	return changed;
+}
+
+bool ObjectSim::ApplyTransformChanges()
 {
 	// Bitwise is intended, yes. Check all and if any changed return true
-	return pos.Update() | scale.Update() | orient.Update();
+	transformChanged = pos.ApplyUpdate() | scale.ApplyUpdate() | orient.ApplyUpdate();
+
+	return transformChanged;
+}
+
+void ObjectSim::FlushTransformCallbacks()
+{
+	if (transformChanged)
+	{
+		transformChanged = false;
+
+		pos.FlushUpdateCallback();
+		scale.FlushUpdateCallback();
+		orient.FlushUpdateCallback();
+	}
 }
 
 void ObjectSim::SetLastPosition(bool executeLinkedObjects)
@@ -5,6 +5,7 @@
 #include "stdEx/utilityEx.h"
 
 #include <unordered_map>
+#include <atomic>
 
 #include "SimSerializer.h"
 #include "ValueObserver.h"
@@ -18,7 +19,8 @@ private:
 	void RotateImpl(const Rotation& toRotate);
 	glm::quat CalcOrientationFromRotation(const Rotation& toRotate);
 protected:
-	static inline float renderDeltaTime = 1.0f;
+	// Set by the render thread, read by the simulation
+	static inline std::atomic<float> renderDeltaTime = 1.0f;
 
 	std::string GetSimInfoToSaveImpl();
 	bool SetSimInfoToLoad(std::string_view& line);
@@ -37,6 +39,7 @@ protected:
 
 	static inline stdEx::RelationGraph<ObjectSim*> objectGraph;
 	bool visited; // Utility bool to prevent infinite loops of linked object traversal
+	bool transformChanged; // Set by ApplyTransformChanges until callbacks are flushed
 	bool objectLinkingEnabled;
 	std::array<bool, std::to_underlying(LinkableFuncNames::_SIZE)> objectLinkingForFuncTracker;
 public:
@@ -55,7 +58,11 @@ public:
 	static const glm::vec3& GetWorldAxisVector(Axis axis);
 
 	// True if values updated
-	virtual bool UpdateTransform();
+	bool UpdateTransform();
+	// Parallel phase of the update, touches only this object: applies accumulated changes, true if values updated
+	virtual bool ApplyTransformChanges();
+	// Serial phase of the update, after all objects applied their changes: executes callbacks with side effects
+	virtual void FlushTransformCallbacks();
 
 	void InvertMovement(bool value = true, bool executeLinkedObjects = true) override;
 	bool IsMovementInverted() override;
@@ -3,6 +3,8 @@
 #include <chrono>
 #include <functional>
 
+#include "EngineClock.h"
+
 class PlaybackManager
 {
 public:
@@ -11,16 +13,25 @@ private:
 	bool playing;
 	bool paused;
 	bool looped;
+	bool followsRealTime;
 
-	std::chrono::system_clock::time_point startPlaybackTime;
-	std::chrono::system_clock::time_point currentPlaybackTime;
+	EngineClock::TimePoint startPlaybackTime;
+	EngineClock::TimePoint currentPlaybackTime;
 
 	StateChangeCallback stateChangeCallback;
 
 	friend class SolidSim;
 
+	EngineClock::TimePoint Now() const
+	{
+		return followsRealTime ? EngineClock::GetRealTime() : EngineClock::GetTime();
+	}
+
 public:
-	PlaybackManager()
+	// Playback follows game time of the engine clock, or its real time if 'followsRealTime',
+	// for playbacks which can not be slowed down or paused with the game
+	PlaybackManager(bool followsRealTime = false)
+		: followsRealTime(followsRealTime)
 	{
 		ResetValues();
 	}
@@ -52,19 +63,19 @@ public:
 
 	void ResetPlaybackTime()
 	{
-		startPlaybackTime = currentPlaybackTime = std::chrono::system_clock::now();
+		startPlaybackTime = currentPlaybackTime = Now();
 	}
 
 	void Play(bool loop = false)
 	{
 		if (!playing)
 		{
-			startPlaybackTime = std::chrono::system_clock::now();
+			startPlaybackTime = Now();
 		}
 		else if (paused)
 		{
 			auto requiredDiff = currentPlaybackTime - startPlaybackTime;
-			currentPlaybackTime = std::chrono::system_clock::now();
+			currentPlaybackTime = Now();
 			startPlaybackTime = currentPlaybackTime - requiredDiff;
 		}
 
@@ -112,7 +123,7 @@ public:
 	{
 		if (!paused)
 		{
-			currentPlaybackTime = std::chrono::system_clock::now();
+			currentPlaybackTime = Now();
 		}
 
 		return std::chrono::duration<double>(currentPlaybackTime - startPlaybackTime).count();
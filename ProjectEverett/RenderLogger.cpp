@@ -8,7 +8,7 @@ RenderLogger::RenderLogger(
 	ShaderBehaviourLog&& shaderBehaviourLog,
 	ShaderBehaviourError&& shaderBehaviourError,
 	RenderTextCreateFunc&& createFunc,
-	RenderTextDeleteFunc&& deleteFunc
+	RedrawRequestFunc&& redrawRequestFunc
 )
 	: 
 	glyphs(glyphs), 
@@ -16,11 +16,23 @@ RenderLogger::RenderLogger(
 	shaderBehaviourLog(std::move(shaderBehaviourLog)),
 	shaderBehaviourError(std::move(shaderBehaviourError)),
 	createFunc(std::move(createFunc)), 
-	deleteFunc(std::move(deleteFunc)),
-	counter(0),
-	isRenderEnabled(true)
+	redrawRequestFunc(std::move(redrawRequestFunc)),
+	isRenderEnabled(true),
+	textsChanged(false),
+	linesAddedThisFrame(0),
+	skippedThisFrame(0)
 {
 	startTextPos = CalcFirstTextPos(windowWidth, windowHeight);
+
+	logText   = { "", startTextPos, isRenderEnabled, shader, glyphs, this->shaderBehaviourLog };
+	errorText = { "", startTextPos, isRenderEnabled, shader, glyphs, this->shaderBehaviourError };
+	logText.lineHeight = errorText.lineHeight = lineHeight;
+}
+
+void RenderLogger::CreateTexts()
+{
+	createFunc("RenderLog", logText);
+	createFunc("RenderErrorLog", errorText);
 }
 
 glm::vec3 RenderLogger::CalcFirstTextPos(float windowsWidth, float windowHeight)
@@ -30,62 +42,108 @@ glm::vec3 RenderLogger::CalcFirstTextPos(float windowsWidth, float windowHeight)
 
 void RenderLogger::CreateLogMessage(const std::string& str)
 {
-	CreateMessage(str, shaderBehaviourLog);
+	CreateMessage(str, false);
 }
 
 void RenderLogger::CreateErrorMessage(const std::string& str)
 {
-	CreateMessage(str, shaderBehaviourError);
+	CreateMessage(str, true);
 }
 
-void RenderLogger::CreateMessage(const std::string& str, const std::function<void()>& behaviourToUse)
+void RenderLogger::CreateMessage(const std::string& str, bool error)
+{
+	std::string text = str.substr(0, maxLineLength);
+
+	if (renderMessageCollection.GetCurrentSize())
+	{
+		LogLine& lastLine = renderMessageCollection.GetBack();
+
+		if (lastLine.error == error && lastLine.text == text)
+		{
+			++lastLine.repeatCount;
+			textsChanged = true;
+			return;
+		}
+	}
+
+	// Rest of the burst is only counted, the frame rate does not depend on how much is logged
+	if (linesAddedThisFrame == maxLinesPerFrame)
+	{
+		++skippedThisFrame;
+		return;
+	}
+
+	++linesAddedThisFrame;
+	PushLine({ std::move(text), error, 1 });
+}
+
+void RenderLogger::PushLine(LogLine&& line)
 {
 	if (renderMessageCollection.GetCurrentSize() == maxAmountOfMessages)
 	{
-		ScrollMessages();
+		renderMessageCollection.PopFront();
 	}
 
-	renderMessageCollection.PushBack(
-		{ counter++, { str, GetCurrentTextPosition(), isRenderEnabled, shader, glyphs, behaviourToUse} }
-	);
-	createFunc(std::to_string(renderMessageCollection.GetBack().first), renderMessageCollection.GetBack().second);
+	renderMessageCollection.PushBack(std::move(line));
+	textsChanged = true;
 }
 
-void RenderLogger::ScrollMessages()
+std::string RenderLogger::GetLineText(const LogLine& line)
 {
-	deleteFunc(std::to_string(renderMessageCollection.GetFront().first));
-	renderMessageCollection.PopFront();
+	return line.repeatCount > 1 ? line.text + " (x" + std::to_string(line.repeatCount) + ')' : line.text;
+}
 
+void RenderLogger::Update()
+{
+	if (skippedThisFrame)
+	{
+		PushLine({ "... " + std::to_string(skippedThisFrame) + " more messages", true, 1 });
+		skippedThisFrame = 0;
+	}
+
+	linesAddedThisFrame = 0;
+
+	if (!textsChanged)
+	{
+		return;
+	}
+
+	logText.text.clear();
+	errorText.text.clear();
+
+	// Line of one block is left empty in the other, so lines of both stay at their places
 	for (size_t i = 0; i < renderMessageCollection.GetCurrentSize(); ++i)
 	{
-		renderMessageCollection[i].second.position.y += 15.0f;
+		const LogLine& line = renderMessageCollection[i];
+
+		if (i)
+		{
+			logText.text += '\n';
+			errorText.text += '\n';
+		}
+
+		(line.error ? errorText : logText).text += GetLineText(line);
 	}
-}
 
-glm::vec3 RenderLogger::GetCurrentTextPosition()
-{
-	glm::vec3 currentTextPos = startTextPos;
-	currentTextPos.y -= renderMessageCollection.GetCurrentSize() * 15.0f;
+	textsChanged = false;
 
-	return currentTextPos;
+	// Texts are not redrawn on their own in on demand mode
+	if (redrawRequestFunc)
+	{
+		redrawRequestFunc();
+	}
 }
 
 void RenderLogger::EnableRender(bool value)
 {
 	isRenderEnabled = value;
 
-	for (size_t i = 0; i < renderMessageCollection.GetCurrentSize(); ++i)
-	{
-		renderMessageCollection[i].second.render = isRenderEnabled;
-	}
+	logText.render = errorText.render = isRenderEnabled;
 }
 
 void RenderLogger::UpdateTextPos(float windowWidth, float windowHeight)
 {
 	startTextPos = CalcFirstTextPos(windowWidth, windowHeight);
 
-	for (size_t i = 0; i < renderMessageCollection.GetCurrentSize(); ++i)
-	{
-		renderMessageCollection[i].second.position.y = startTextPos.y - i * 15.0f;
-	}
+	logText.position = errorText.position = startTextPos;
 }
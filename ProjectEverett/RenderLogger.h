@@ -3,13 +3,16 @@
 #include "LGLStructs.h"
 #include "stdEx/utilityEx.h"
 
+// On-screen log as two text blocks drawn on top of each other, one with the log lines and one with the error lines,
+// so each keeps its color. Blocks are rebuilt at most once per frame, repeated messages are coalesced into one line
+// with a counter and lines added per frame are limited, so a storm of messages costs no more than a few lines of text
 class RenderLogger
 {
 public:
 	using ShaderBehaviourLog   = std::function<void()>;
 	using ShaderBehaviourError = std::function<void()>;
 	using RenderTextCreateFunc = std::function<void(const std::string&, LGLStructs::TextInfo&)>;
-	using RenderTextDeleteFunc = std::function<void(const std::string&)>;
+	using RedrawRequestFunc    = std::function<void()>;
 
 	RenderLogger(
 		const float windowWidth,
@@ -18,33 +21,54 @@ public:
 		const std::string& shader,
 		ShaderBehaviourLog&& shaderBehaviourLog,
 		ShaderBehaviourError&& shaderBehaviourError,
-		RenderTextCreateFunc&& createFunc, 
-		RenderTextDeleteFunc&& deleteFunc
+		RenderTextCreateFunc&& createFunc,
+		RedrawRequestFunc&& redrawRequestFunc
 	);
 
+	// Again after texts of LGL were reset
+	void CreateTexts();
+
 	void CreateLogMessage(const std::string& str);
 	void CreateErrorMessage(const std::string& str);
 
+	// Once per frame, applies messages added since the last call to the text blocks and requests a redraw if they changed
+	void Update();
+
 	void EnableRender(bool value = true);
 	void UpdateTextPos(float windowWidth, float windowHeight);
 private:
-	void CreateMessage(const std::string& str, const std::function<void()>& behaviourToUse);
+	struct LogLine
+	{
+		std::string text;
+		bool error;
+		size_t repeatCount;
+	};
+
+	void CreateMessage(const std::string& str, bool error);
+	void PushLine(LogLine&& line);
+	std::string GetLineText(const LogLine& line);
 
 	glm::vec3 CalcFirstTextPos(float windowWidth, float windowHeight);
-	glm::vec3 GetCurrentTextPosition();
-	void ScrollMessages();
 
 	glm::vec3 startTextPos;
 	constexpr static int maxAmountOfMessages = 10; 
+	constexpr static size_t maxLinesPerFrame = 4;
+	constexpr static size_t maxLineLength = 160;
+	constexpr static float lineHeight = 15.0f;
 
 	const LGLStructs::GlyphInfo& glyphs;
 	std::string shader;
 	ShaderBehaviourLog shaderBehaviourLog;
 	ShaderBehaviourError shaderBehaviourError;
 	RenderTextCreateFunc createFunc;
-	RenderTextDeleteFunc deleteFunc;
+	RedrawRequestFunc redrawRequestFunc;
 
-	size_t counter;
 	bool isRenderEnabled;
-	stdEx::RingBuffer<std::pair<size_t, LGLStructs::TextInfo>, maxAmountOfMessages> renderMessageCollection;
-};
\ No newline at end of file
+	bool textsChanged;
+	size_t linesAddedThisFrame;
+	size_t skippedThisFrame;
+	stdEx::RingBuffer<LogLine, maxAmountOfMessages> renderMessageCollection;
+
+	LGLStructs::TextInfo logText;
+	LGLStructs::TextInfo errorText;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <array>
+
+#include "LightSim.h"
+
+class ModelInfo;
+
+// State of the scene the render thread needs for one frame, copied out of the sims at the end of a simulation step.
+// Render thread only reads it, so the simulation can go on with the next step meanwhile
+struct SceneSnapshot
+{
+	struct Transform
+	{
+		glm::vec3 pos;
+		glm::quat orient;
+		glm::vec3 scale;
+	};
+
+	struct SolidEntry
+	{
+		bool visible;
+		glm::mat4 model;
+		glm::mat4 inverseModel;
+		int startingBoneIndex; // -1 if solid has no animations
+		glm::vec4 defaultColor;
+
+		// With a fixed simulation step only: states before and after the last step, if they differ
+		bool moved = false;
+		Transform previous{};
+		Transform current{};
+
+		// Same composition as the model matrix of the solid
+		glm::mat4 GetInterpolatedModel(float alpha) const
+		{
+			glm::mat4 interpolated = glm::translate(glm::mat4(1.0f), glm::mix(previous.pos, current.pos, alpha));
+			interpolated *= glm::mat4_cast(glm::slerp(previous.orient, current.orient, alpha));
+
+			return glm::scale(interpolated, glm::mix(previous.scale, current.scale, alpha));
+		}
+	};
+
+	struct ModelEntry
+	{
+		size_t snapshotIndex;
+		size_t meshAmount;
+		// Same order as related solids of the model
+		std::vector<SolidEntry> solids;
+		// Per solid, meshAmount values each
+		std::vector<char> meshVisibility;
+		std::vector<float> meshShininess;
+	};
+
+	struct LightEntry
+	{
+		LightSim::LightTypes type;
+		glm::vec3 pos;
+		glm::vec3 front;
+		glm::vec3 color;
+		LightSim::Attenuation atten;
+	};
+
+	size_t snapshotIndex = 0; // 0 until the first snapshot is written
+
+	glm::mat4 proj = glm::mat4(1.0f);
+	glm::mat4 view = glm::mat4(1.0f);
+	glm::vec3 viewPos{};
+	glm::vec3 ambient{};
+
+	// Part of the fixed step passed since the last step, solids are rendered that far between their two states
+	bool interpolated = false;
+	float interpolationAlpha = 1.0f;
+
+	std::array<int, LightSim::LightTypes::_SIZE> lightAmounts{};
+	std::vector<LightEntry> lights;
+
+	std::vector<glm::mat4> bones;
+
+	// Entries of deleted models are dropped on the next snapshot written to the same buffer, never dereferenced
+	std::unordered_map<const ModelInfo*, ModelEntry> models;
+	std::vector<std::pair<std::string, float>> modelScreenSizes;
+	// Models without solids with seconds since their last solid was removed
+	std::vector<std::pair<std::string, float>> unusedModels;
+};
@@ -23,6 +23,7 @@ SolidSim::SolidSim(
 	: ObjectSim(pos, scale, speed)
 {
 	ResetModelMatrix();
+	StorePreviousTransform();
 }
 
 void SolidSim::SetPositionVector(const glm::vec3& vect, bool executeLinkedObjects)
@@ -90,6 +91,7 @@ bool SolidSim::CollectInfoToLoadToSTMM(std::string_view& line)
 		res = res && SimSerializer::SetValueToLoadFrom(line, STMM.modelDefaultColor,              8);
 
 		STMM.CheckIfModelVisible();
+		STMM.modelInfoPtr->RecheckAllMeshVisibility();
 	}
 
 	return res;
@@ -149,9 +151,33 @@ glm::mat4 SolidSim::GetInverseModelMatrix()
 	return invModel;
 }
 
-bool SolidSim::UpdateTransform()
+void SolidSim::StorePreviousTransform()
 {
-	if (ObjectSim::UpdateTransform())
+	const glm::vec3& posRef = pos;
+	const glm::vec3& scaleRef = scale;
+	const glm::quat& orientRef = orient;
+
+	previousPos = posRef;
+	previousOrient = orientRef;
+	previousScale = scaleRef;
+}
+
+bool SolidSim::GetPreviousTransform(glm::vec3& pos, glm::quat& orient, glm::vec3& scale)
+{
+	pos = previousPos;
+	orient = previousOrient;
+	scale = previousScale;
+
+	const glm::vec3& posRef = this->pos;
+	const glm::vec3& scaleRef = this->scale;
+	const glm::quat& orientRef = this->orient;
+
+	return pos != posRef || orient != orientRef || scale != scaleRef;
+}
+
+bool SolidSim::ApplyTransformChanges()
+{
+	if (ObjectSim::ApplyTransformChanges())
 	{
 		ResetModelMatrix();
 
@@ -22,6 +22,11 @@ private:
 	glm::mat4 invModel;
 	bool recalcInv{};
 
+	// State before the last fixed simulation step, rendering interpolates from it
+	glm::vec3 previousPos;
+	glm::quat previousOrient;
+	glm::vec3 previousScale;
+
 	SolidToModelManager STMM;
 
 	void ResetModelMatrix();
@@ -43,7 +48,7 @@ public:
 	std::string GetThisObjectTypeNameStr() override;
 	static std::string GetObjectTypeNameStr();
 
-	bool UpdateTransform() override;
+	bool ApplyTransformChanges() override;
 
 	std::string GetSimInfoToSave(const std::string& modelSolidName);
 	bool SetSimInfoToLoad(std::string_view& line);
@@ -51,6 +56,10 @@ public:
 	const glm::mat4& GetModelMatrixAddr();
 	// Inverse matrix is recalculated only on call if model matrix was updated
 	glm::mat4 GetInverseModelMatrix();
+
+	void StorePreviousTransform();
+	// False if the transform did not change since it was stored
+	bool GetPreviousTransform(glm::vec3& pos, glm::quat& orient, glm::vec3& scale);
 	
 	// Solid to model access section
 	// Mesh access; available through interface
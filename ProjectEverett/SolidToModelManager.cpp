@@ -65,13 +65,10 @@ void SolidToModelManager::SetModelVisibility(bool value)
 	CheckIfInitialized();
 
 	std::fill(meshVisibility.begin(), meshVisibility.end(), value);
-	bool previousModelVisibility = modelVisibility;
 	modelVisibility = value;
 
-	if (previousModelVisibility != modelVisibility)
-	{
-		modelInfoPtr->RecheckIfAllRelatedSolidsAreVisible();
-	}
+	// Mesh visibility is overwritten regardless of previous model visibility, so always recheck
+	modelInfoPtr->RecheckIfAllRelatedSolidsAreVisible();
 }
 
 bool SolidToModelManager::GetModelVisibility()
@@ -103,6 +100,7 @@ void SolidToModelManager::SetMeshVisibility(size_t index, bool value)
 	meshVisibility[index] = value;
 
 	CheckIfModelVisible();
+	modelInfoPtr->RecheckMeshVisibility(index);
 }
 
 void SolidToModelManager::SetMeshVisibility(const std::string& name, bool value)
@@ -111,10 +109,12 @@ void SolidToModelManager::SetMeshVisibility(const std::string& name, bool value)
 
 	if (fullModelInfoP)
 	{
-		meshVisibility[GetIndexByName(name, GetMeshNames())] = value;
-	}
+		size_t index = GetIndexByName(name, GetMeshNames());
+		meshVisibility[index] = value;
 
-	CheckIfModelVisible();
+		CheckIfModelVisible();
+		modelInfoPtr->RecheckMeshVisibility(index);
+	}
 }
 
 bool SolidToModelManager::GetMeshVisibility(size_t index)
@@ -7,7 +7,7 @@
 #include <iostream>
 
 #include "ContextManager.h"
-#define ContextLock ContextManager<ALCcontext> mux(context);
+#define ContextLock ContextManager<ALCcontext> mux(contextHolder);
 
 #include "EverettExceptionInternal.h"
 
@@ -56,6 +56,8 @@ void SoundSim::TerminateOpenAL()
 	if (context)
 	{
 		alcDestroyContext(context);
+		context = nullptr;
+		contextHolder.SetContext(nullptr);
 	}
 	
 	if (device)
@@ -91,9 +93,15 @@ void SoundSim::UpdateCameraPosition()
 	}
 }
 
+bool SoundSim::IsAnySoundPlaying()
+{
+	return soundsCurrentlyPlaying > 0;
+}
+
 bool SoundSim::CreateContext()
 {
 	context = alcCreateContext(device, nullptr);
+	contextHolder.SetContext(context);
 
 	return context;
 }
@@ -208,9 +216,13 @@ void SoundSim::UpdateCurrentPlaybackTime()
 	}
 }
 
-bool SoundSim::UpdateTransform()
+void SoundSim::FlushTransformCallbacks()
 {
-	if (ObjectSim::UpdateTransform() && sound.playStates.IsPlaying())
+	const bool changed = transformChanged;
+
+	ObjectSim::FlushTransformCallbacks();
+
+	if (changed && sound.playStates.IsPlaying())
 	{
 		ContextLock
 
@@ -219,11 +231,7 @@ bool SoundSim::UpdateTransform()
 		const glm::vec3& currentPos = pos;
 		alSource3f(sound.source, AL_POSITION, currentPos.x, currentPos.y, currentPos.z);
 		alSource3f(sound.source, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
-
-		return true;
 	}
-
-	return false;
 }
 
 void SoundSim::SetPlaybackCallback(std::function<void(bool, bool, bool)> callback)
@@ -7,6 +7,7 @@
 
 #include "CommonStructs.h"
 #include "PlaybackManager.h"
+#include "ContextManager.h"
 
 struct ALCdevice;
 struct ALCcontext;
@@ -16,6 +17,8 @@ class SoundSim final : public ObjectSim, public ISoundSim
 private:
 	static inline ALCdevice* device = nullptr;
 	static inline ALCcontext* context = nullptr;
+	// Sounds share a single context, its lock is separate from the one of rendering
+	static inline ContextHolder<ALCcontext> contextHolder;
 	static inline std::weak_ptr<CameraSim> camera;
 	static inline int soundsCurrentlyPlaying = 0;
 
@@ -25,7 +28,8 @@ private:
 
 	struct SoundInfo : WavData
 	{
-		PlaybackManager playStates;
+		// OpenAL plays sources in real time regardless of the game time
+		PlaybackManager playStates{ true };
 
 		float playbackSpeed{};
 
@@ -53,12 +57,13 @@ public:
 	std::string GetSimInfoToSave(const std::string& soundName);
 	bool SetSimInfoToLoad(std::string_view& line);
 
-	bool UpdateTransform() override;
+	void FlushTransformCallbacks() override;
 
 	static void InitOpenAL();
 	static void TerminateOpenAL();
 	static void SetCamera(std::weak_ptr<CameraSim> camera);
 	static void UpdateCameraPosition();
+	static bool IsAnySoundPlaying();
 	SoundSim() = default;
 	SoundSim(WavData&& wavData);
 	SoundSim(SoundSim&& otherSoundSim) noexcept;
@@ -2,61 +2,308 @@
 
 #include "external/IEverettEngine.h"
 
+#include <array>
+#include <bitset>
+#include <unordered_map>
+#include <cmath>
+#include <cstdint>
+
+/*
+	Hierarchical timing wheel with millisecond ticks. Every level has 256 slots, a slot of level N spans 256^N ticks,
+	so four levels cover 49 days ahead. Callbacks are kept in the slot of their due tick and moved a level down
+	once the lower level reaches their range, adding and cancelling never looks at other callbacks.
+	Advancing visits only ticks with a callback due, using occupancy of the lowest level
+*/
 class TimerManager
 {
+	using Handle = IEverettEngine::TimedCallbackHandle;
+
+	constexpr static size_t levelBits = 8;
+	constexpr static size_t slotAmount = 1 << levelBits;
+	constexpr static size_t slotMask = slotAmount - 1;
+	constexpr static size_t levelAmount = 4;
+	constexpr static uint64_t maxDelay = (uint64_t(1) << (levelBits * levelAmount)) - 1;
+
 	struct TimedCallback : IEverettEngine::TimedCallbackSetup
 	{
-		std::chrono::steady_clock::time_point tickStartTime = std::chrono::steady_clock::now();
+		Handle handle{};
+		uint64_t periodTicks{};
+		uint64_t dueTick{};
 		size_t currentCallCount{};
+		bool cancelled = false;
+
+		// Intrusive list of the slot the callback is in
+		TimedCallback* prev = nullptr;
+		TimedCallback* next = nullptr;
+		TimedCallback** slotHead = nullptr;
+	};
+
+	struct Level
+	{
+		std::array<TimedCallback*, slotAmount> slots{};
+		std::bitset<slotAmount> occupied;
 	};
 
-	std::forward_list<TimedCallback> timedCallbacks;
+	// Nodes of unordered_map keep their address, slot lists point into it
+	std::unordered_map<Handle, TimedCallback> timedCallbacks;
+	std::array<Level, levelAmount> levels;
+	Handle lastHandle{};
 
-	auto DeleteTimedCallback(std::forward_list<TimedCallback>::iterator beforeIter)
+	uint64_t currentTick{}; // Last processed tick
+	double pendingMs{};     // Part of a tick passed, but not processed yet
+
+	Handle executedHandle{};
+
+	static size_t SlotIndex(uint64_t tick, size_t level)
 	{
-		return timedCallbacks.erase_after(beforeIter);
+		return (tick >> (levelBits * level)) & slotMask;
 	}
 
-public:
-	void AddTimedCallback(IEverettEngine::TimedCallbackSetup&& timedCallbackSetup)
+	void Link(TimedCallback& timedCallback)
+	{
+		const uint64_t delay = timedCallback.dueTick > currentTick ? timedCallback.dueTick - currentTick : 0;
+
+		// Callbacks further than the wheel covers are parked in the last slot it reaches and placed again from there
+		const uint64_t placementTick = currentTick + std::min(delay, maxDelay);
+
+		size_t level = 0;
+		while (level + 1 < levelAmount && delay >> (levelBits * (level + 1)))
+		{
+			++level;
+		}
+
+		const size_t slot = SlotIndex(placementTick, level);
+		TimedCallback*& head = levels[level].slots[slot];
+
+		timedCallback.prev = nullptr;
+		timedCallback.next = head;
+		timedCallback.slotHead = &head;
+
+		if (head)
+		{
+			head->prev = &timedCallback;
+		}
+
+		head = &timedCallback;
+		levels[level].occupied.set(slot);
+	}
+
+	void Unlink(TimedCallback& timedCallback)
 	{
-		timedCallbacks.push_front(TimedCallback{ std::move(timedCallbackSetup) });
+		if (!timedCallback.slotHead)
+		{
+			return;
+		}
+
+		if (timedCallback.prev)
+		{
+			timedCallback.prev->next = timedCallback.next;
+		}
+		else
+		{
+			*timedCallback.slotHead = timedCallback.next;
+		}
+
+		if (timedCallback.next)
+		{
+			timedCallback.next->prev = timedCallback.prev;
+		}
+
+		timedCallback.prev = timedCallback.next = nullptr;
+		timedCallback.slotHead = nullptr;
 	}
 
-	void ProcessTimedCallbacks()
+	// Detaches the whole list of a slot
+	TimedCallback* TakeSlot(size_t level, size_t slot)
 	{
-		if (timedCallbacks.empty()) return;
+		TimedCallback* head = levels[level].slots[slot];
+		levels[level].slots[slot] = nullptr;
+		levels[level].occupied.reset(slot);
+
+		for (TimedCallback* current = head; current; current = current->next)
+		{
+			current->slotHead = nullptr;
+		}
 
-		auto currentTime = std::chrono::steady_clock::now();
-		auto beforeCurrent = timedCallbacks.before_begin();
+		return head;
+	}
 
-		for (auto currentIter = std::next(beforeCurrent); currentIter != timedCallbacks.end();)
+	// Moves callbacks of higher level slots which the lowest level reaches with 'currentTick' into lower levels
+	void Cascade()
+	{
+		for (size_t level = 1; level < levelAmount; ++level)
 		{
-			TimedCallback& currentCallback = *currentIter;
+			if (SlotIndex(currentTick, level - 1))
+			{
+				break;
+			}
+
+			const size_t slot = SlotIndex(currentTick, level);
 
-			if ((currentCallback.endTrigger && *currentCallback.endTrigger) ||
-				(currentCallback.amountOfCalls && currentCallback.currentCallCount == *currentCallback.amountOfCalls))
+			if (!levels[level].occupied.test(slot))
 			{
-				currentIter = DeleteTimedCallback(beforeCurrent);
+				continue;
 			}
-			else 
+
+			for (TimedCallback* current = TakeSlot(level, slot); current;)
 			{
-				if (std::chrono::duration_cast<std::chrono::seconds>(currentTime - currentCallback.tickStartTime)
-					>= currentCallback.period)
-				{
-					currentCallback.tickStartTime = currentTime;
+				TimedCallback* next = current->next;
+				Link(*current);
+				current = next;
+			}
+		}
+	}
 
-					currentCallback.callback(++currentCallback.currentCallCount);
-				}
+	// Ticks until the next one with callbacks of the lowest level due or with a cascade, not more than 'maxTicks'
+	uint64_t TicksToNextEvent(uint64_t maxTicks)
+	{
+		const size_t currentSlot = SlotIndex(currentTick, 0);
+		const uint64_t ticksLimit = std::min<uint64_t>(slotAmount - currentSlot, maxTicks);
 
-				beforeCurrent = currentIter;
-				currentIter = std::next(currentIter);
+		for (uint64_t ticks = 1; ticks < ticksLimit; ++ticks)
+		{
+			if (levels[0].occupied.test(currentSlot + ticks))
+			{
+				return ticks;
 			}
 		}
+
+		return ticksLimit;
+	}
+
+	bool ExecuteSlot(size_t slot)
+	{
+		bool callbackCalled = false;
+
+		// Callbacks can add and cancel others, so the slot is taken one callback at a time
+		while (TimedCallback* current = levels[0].slots[slot])
+		{
+			Unlink(*current);
+
+			if ((current->endTrigger && current->endTrigger->get()) ||
+				(current->amountOfCalls && current->currentCallCount >= *current->amountOfCalls))
+			{
+				timedCallbacks.erase(current->handle);
+				continue;
+			}
+
+			executedHandle = current->handle;
+			current->callback(++current->currentCallCount);
+			executedHandle = {};
+			callbackCalled = true;
+
+			if (current->cancelled || (current->amountOfCalls && current->currentCallCount >= *current->amountOfCalls))
+			{
+				timedCallbacks.erase(current->handle);
+				continue;
+			}
+
+			// Period is counted from the due tick, so callbacks keep their cadence regardless of the frame rate
+			current->dueTick += current->periodTicks;
+			Link(*current);
+		}
+
+		levels[0].occupied.reset(slot);
+
+		return callbackCalled;
+	}
+
+public:
+	Handle AddTimedCallback(IEverettEngine::TimedCallbackSetup&& timedCallbackSetup)
+	{
+		const Handle handle = ++lastHandle;
+		const uint64_t periodTicks = std::max<long long>(std::llround(timedCallbackSetup.period.count() * 1000.0), 1);
+
+		TimedCallback& timedCallback = timedCallbacks.emplace(handle, TimedCallback{ std::move(timedCallbackSetup) }).first->second;
+		timedCallback.handle = handle;
+		timedCallback.periodTicks = periodTicks;
+		timedCallback.dueTick = currentTick + periodTicks;
+
+		Link(timedCallback);
+
+		return handle;
+	}
+
+	// False if the callback has already ended or was never added
+	bool CancelTimedCallback(Handle handle)
+	{
+		auto iter = timedCallbacks.find(handle);
+
+		if (iter == timedCallbacks.end() || iter->second.cancelled)
+		{
+			return false;
+		}
+
+		// Callback being executed is removed once it returns
+		if (handle == executedHandle)
+		{
+			iter->second.cancelled = true;
+			return true;
+		}
+
+		Unlink(iter->second);
+		timedCallbacks.erase(iter);
+
+		return true;
+	}
+
+	size_t GetTimedCallbackAmount()
+	{
+		return timedCallbacks.size();
+	}
+
+	// Advances the wheel by 'elapsedSeconds' of game time. True if any callback was called
+	bool ProcessTimedCallbacks(float elapsedSeconds)
+	{
+		pendingMs += std::max(elapsedSeconds, 0.0f) * 1000.0;
+
+		uint64_t ticksLeft = static_cast<uint64_t>(pendingMs);
+		pendingMs -= static_cast<double>(ticksLeft);
+
+		if (timedCallbacks.empty())
+		{
+			currentTick += ticksLeft;
+			return false;
+		}
+
+		bool callbackCalled = false;
+
+		// Due callbacks of the ticks passed are executed in order of their ticks
+		while (ticksLeft)
+		{
+			const uint64_t ticks = TicksToNextEvent(ticksLeft);
+			currentTick += ticks;
+			ticksLeft -= ticks;
+
+			if (!SlotIndex(currentTick, 0))
+			{
+				Cascade();
+			}
+
+			const size_t slot = SlotIndex(currentTick, 0);
+
+			if (levels[0].occupied.test(slot))
+			{
+				callbackCalled |= ExecuteSlot(slot);
+			}
+		}
+
+		return callbackCalled;
 	}
 
 	void CleanTimedCallbacks()
 	{
-		timedCallbacks.clear();
+		for (auto iter = timedCallbacks.begin(); iter != timedCallbacks.end();)
+		{
+			if (iter->first == executedHandle)
+			{
+				iter->second.cancelled = true;
+				++iter;
+				continue;
+			}
+
+			Unlink(iter->second);
+			iter = timedCallbacks.erase(iter);
+		}
 	}
-};
\ No newline at end of file
+};
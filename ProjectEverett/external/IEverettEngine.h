@@ -19,9 +19,12 @@ public:
 		Camera, Solid, Light, Sound, Collider, _SIZE
 	};
 
+	// 0 is never returned for an added callback
+	using TimedCallbackHandle = size_t;
+
 	struct TimedCallbackSetup
 	{
-		std::chrono::seconds period;
+		std::chrono::duration<double> period; // Game time, fractional seconds are rounded to milliseconds
 		std::function<void(size_t)> callback; // size_t will equal to amount of times 'this' callback was called
 		std::optional<size_t> amountOfCalls; // Infinite if not set, stops callbacks on reached amount
 		std::optional<std::reference_wrapper<bool>> endTrigger; // Stops callbacks on 'true' value (regardless on amount of calls)
@@ -35,7 +38,9 @@ public:
 		std::function<void()> pressFunc,
 		std::function<void()> releaseFunc = nullptr
 	) = 0;
-	virtual void AddTimedCallback(TimedCallbackSetup timedCallbackSetup) = 0;
+	virtual TimedCallbackHandle AddTimedCallback(TimedCallbackSetup timedCallbackSetup) = 0;
+	// False if the callback has already ended or the handle is unknown. Can be called from the callback itself
+	virtual bool CancelTimedCallback(TimedCallbackHandle handle) = 0;
 	virtual void AddMouseScrollCallback(std::function<void(double)> callback) = 0;
 	virtual void AddMouseMoveCallback(std::function<void(double, double)> callback) = 0;
 
@@ -53,6 +58,13 @@ public:
 
 	virtual void RequestWorldLoad(const char* path) = 0;
 
+	// Splits [0, count) into [begin, end) ranges executed by the engine job workers and the calling thread, returns once all are done.
+	// Ranges are not shorter than minBatchSize, so small loops are not split at all
+	virtual void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func, size_t minBatchSize = 64) = 0;
+
+	// With on demand rendering, the next frame is rendered even if nothing observed by the engine changed
+	virtual void RequestRedraw() = 0;
+
 	virtual void CreateLogReport() = 0;
 
 	// False by default. If true, will throw on failed interface get. 